@@ -0,0 +1,43 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#include "AsyncLoadRelatedWorld.h"
+#include "WorldDirector.h"
+#include "RelatedWorld.h"
+
+UAsyncLoadRelatedWorld* UAsyncLoadRelatedWorld::LoadRelatedWorldAsync(UObject* WorldContextObject, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld, FName CreateProfile)
+{
+	UAsyncLoadRelatedWorld* Action = NewObject<UAsyncLoadRelatedWorld>();
+	Action->WorldContextObject = WorldContextObject;
+	Action->WorldName = WorldName;
+	Action->WorldTranslation = WorldTranslation;
+	Action->WorldDomain = WorldDomain;
+	Action->bNetWorld = IsNetWorld;
+	Action->CreateProfile = CreateProfile;
+	Action->RegisterWithGameInstance(WorldContextObject);
+
+	return Action;
+}
+
+void UAsyncLoadRelatedWorld::Activate()
+{
+	FOnRelatedWorldLoaded Callback = FOnRelatedWorldLoaded::CreateUObject(this, &UAsyncLoadRelatedWorld::HandleWorldLoaded);
+
+	if (!UWorldDirector::Get()->LoadRelatedWorldAsync(WorldContextObject, WorldName, WorldTranslation, WorldDomain, bNetWorld, Callback, CreateProfile))
+	{
+		HandleWorldLoaded(WorldName, nullptr);
+	}
+}
+
+void UAsyncLoadRelatedWorld::HandleWorldLoaded(FName LoadedWorldName, URelatedWorld* World)
+{
+	if (World != nullptr)
+	{
+		OnLoaded.Broadcast(World);
+	}
+	else
+	{
+		OnFailed.Broadcast(nullptr);
+	}
+
+	SetReadyToDestroy();
+}
@@ -3,7 +3,10 @@
 #include "Components/RelatedLocationComponent.h"
 #include "WorldDirector.h"
 #include "RelatedWorld.h"
+#include "RelatedWorldInfo.h"
 
+#include "Engine/NetDriver.h"
+#include "Net/RepLayout.h"
 #include "Net/UnrealNetwork.h"
 
 URelatedLocationComponent::URelatedLocationComponent()
@@ -16,7 +19,23 @@ void URelatedLocationComponent::GetLifetimeReplicatedProps(TArray< class FLifeti
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(URelatedLocationComponent, WorldTranslation);
+	DOREPLIFETIME(URelatedLocationComponent, WorldId);
+	DOREPLIFETIME_CONDITION(URelatedLocationComponent, CompactBounds, COND_InitialOnly);
+	DOREPLIFETIME_CONDITION_NOTIFY(URelatedLocationComponent, CompactMovement, COND_SimulatedOrPhysics, REPNOTIFY_Always);
+}
+
+void URelatedLocationComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// Clients create the component from replication and receive movement before it is initialized
+	if (AActor* Owner = GetOwner())
+	{
+		CompactMovement.SetQuantization(Owner->GetReplicatedMovement());
+	}
+
+	// Set after archetype properties are copied, so it points to bounds of this component
+	CompactMovement.SetLayoutBounds(&CompactBounds);
 }
 
 void URelatedLocationComponent::InitializeComponent()
@@ -25,9 +44,10 @@ void URelatedLocationComponent::InitializeComponent()
 
 	if (RelatedWorld != nullptr && GetNetMode() == NM_DedicatedServer)
 	{
+		WorldId = RelatedWorld->GetWorldId();
 		WorldTranslation = RelatedWorld->GetWorldTranslation();
-
-		RelatedWorld->OnWorldTranslationChanged.AddDynamic(this, &URelatedLocationComponent::RelatedWorldReceiveNewTranslation);
+		WorldTranslationVersion = RelatedWorld->GetTranslationVersion();
+		CompactBounds = RelatedWorld->GetLocalBounds();
 	}
 
 	Super::InitializeComponent();
@@ -35,24 +55,77 @@ void URelatedLocationComponent::InitializeComponent()
 
 void URelatedLocationComponent::UninitializeComponent()
 {
-	if (RelatedWorld != nullptr && GetOwnerRole() == ROLE_Authority)
+	UnbindWorldInfo();
+
+	Super::UninitializeComponent();
+}
+
+void URelatedLocationComponent::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	SyncWorldTranslation();
+
+	DOREPLIFETIME_ACTIVE_OVERRIDE(URelatedLocationComponent, CompactMovement, UpdateCompactMovement());
+
+	Super::PreReplication(ChangedPropertyTracker);
+}
+
+bool URelatedLocationComponent::UpdateCompactMovement()
+{
+	AActor* Owner = GetOwner();
+
+	if (RelatedWorld == nullptr || !RelatedWorld->IsCompactMovement() || RelatedWorld->GetWorldId() == 0 || !CompactBounds.IsValid || !Owner->IsReplicatingMovement())
 	{
-		RelatedWorld->OnWorldTranslationChanged.RemoveDynamic(this, &URelatedLocationComponent::RelatedWorldReceiveNewTranslation);
+		return false;
 	}
-	
-	Super::UninitializeComponent();
+
+	UNetDriver* NetDriver = Owner->GetNetDriver();
+	static FProperty* ReplicatedMovementProperty = AActor::StaticClass()->FindPropertyByName(TEXT("ReplicatedMovement"));
+
+	if (NetDriver == nullptr || ReplicatedMovementProperty == nullptr)
+	{
+		return false;
+	}
+
+	CompactMovement.SetMovement(Owner->GetReplicatedMovement());
+
+	// Owner PreReplication runs before components, so this override wins for the frame
+#if ENGINE_MINOR_VERSION >= 26
+	NetDriver->FindOrCreateRepChangedPropertyTracker(Owner)->SetCustomIsActiveOverride(Owner, ReplicatedMovementProperty->RepIndex, false);
+#else
+	NetDriver->FindOrCreateRepChangedPropertyTracker(Owner)->SetCustomIsActiveOverride(ReplicatedMovementProperty->RepIndex, false);
+#endif
+
+	return true;
 }
 
 void URelatedLocationComponent::NotifyWorldChanged(URelatedWorld* NewWorld)
 {
-	RelatedWorld->OnWorldTranslationChanged.RemoveDynamic(this, &URelatedLocationComponent::RelatedWorldReceiveNewTranslation);
-	NewWorld->OnWorldTranslationChanged.AddDynamic(this, &URelatedLocationComponent::RelatedWorldReceiveNewTranslation);
-
 	RelatedWorld = NewWorld;
+	WorldId = RelatedWorld->GetWorldId();
+	WorldTranslationVersion = RelatedWorld->GetTranslationVersion();
+
 	OnRelatedWorldChanged.Broadcast(RelatedWorld);
 	NotifyWorldTranslationChanged(RelatedWorld->GetWorldTranslation(), false);
 }
 
+const FIntVector& URelatedLocationComponent::GetWorldTranslation()
+{
+	SyncWorldTranslation();
+
+	return WorldTranslation;
+}
+
+void URelatedLocationComponent::SyncWorldTranslation()
+{
+	if (RelatedWorld == nullptr || GetOwnerRole() != ROLE_Authority || RelatedWorld->GetTranslationVersion() == WorldTranslationVersion)
+	{
+		return;
+	}
+
+	WorldTranslationVersion = RelatedWorld->GetTranslationVersion();
+	NotifyWorldTranslationChanged(RelatedWorld->GetWorldTranslation());
+}
+
 void URelatedLocationComponent::NotifyWorldTranslationChanged(const FIntVector& NewWorldTranslation, bool DispatchEvent)
 {
 	WorldTranslation = NewWorldTranslation;
@@ -63,13 +136,77 @@ void URelatedLocationComponent::NotifyWorldTranslationChanged(const FIntVector&
 	}
 }
 
-void URelatedLocationComponent::RelatedWorldReceiveNewTranslation(const FIntVector& NewWorldTranslation)
+void URelatedLocationComponent::OnRep_WorldId()
+{
+	UnbindWorldInfo();
+
+	if (WorldId == 0)
+	{
+		return;
+	}
+
+	if (ARelatedWorldInfo* Info = ARelatedWorldInfo::FindWorldInfo(GetWorld(), WorldId))
+	{
+		BindWorldInfo(Info);
+	}
+	else
+	{
+		WorldInfoAddedHandle = ARelatedWorldInfo::OnWorldInfoAdded.AddUObject(this, &URelatedLocationComponent::HandleWorldInfoAdded);
+	}
+}
+
+void URelatedLocationComponent::HandleWorldInfoAdded(ARelatedWorldInfo* Info)
+{
+	if (Info->GetWorldId() != WorldId || Info->GetWorld() != GetWorld())
+	{
+		return;
+	}
+
+	ARelatedWorldInfo::OnWorldInfoAdded.Remove(WorldInfoAddedHandle);
+	WorldInfoAddedHandle.Reset();
+
+	BindWorldInfo(Info);
+}
+
+void URelatedLocationComponent::BindWorldInfo(ARelatedWorldInfo* Info)
 {
-	NotifyWorldTranslationChanged(NewWorldTranslation);
+	WorldInfo = Info;
+	WorldTranslationHandle = Info->OnWorldTranslationChanged.AddUObject(this, &URelatedLocationComponent::HandleWorldTranslationChanged);
+
+	HandleWorldTranslationChanged(Info);
+	ApplyCompactMovement();
+
+	// Movement received before the info was rebased without translation, rebase it again
+	if (bMovementRebasePending)
+	{
+		FRepMovement Movement = GetOwner()->GetReplicatedMovement();
+		Movement.Location = PendingMovementLocation;
+		GetOwner()->SetReplicatedMovement(Movement);
+		RebaseReplicatedMovement();
+	}
+}
+
+void URelatedLocationComponent::UnbindWorldInfo()
+{
+	if (WorldInfoAddedHandle.IsValid())
+	{
+		ARelatedWorldInfo::OnWorldInfoAdded.Remove(WorldInfoAddedHandle);
+		WorldInfoAddedHandle.Reset();
+	}
+
+	if (ARelatedWorldInfo* Info = WorldInfo.Get())
+	{
+		Info->OnWorldTranslationChanged.Remove(WorldTranslationHandle);
+	}
+
+	WorldTranslationHandle.Reset();
+	WorldInfo = nullptr;
 }
 
-void URelatedLocationComponent::OnRep_WorldTranslation()
+void URelatedLocationComponent::HandleWorldTranslationChanged(ARelatedWorldInfo* Info)
 {
+	WorldTranslation = Info->GetWorldTranslation();
+
 	APawn* Owner = Cast<APawn>(GetOwner());
 
 	if (Owner != nullptr && Owner->IsLocallyControlled())
@@ -79,3 +216,40 @@ void URelatedLocationComponent::OnRep_WorldTranslation()
 
 	OnRelatedWorldTranslationChanged.Broadcast(WorldTranslation);
 }
+
+void URelatedLocationComponent::OnRep_CompactMovement()
+{
+	bCompactMovementPending = true;
+	ApplyCompactMovement();
+}
+
+void URelatedLocationComponent::ApplyCompactMovement()
+{
+	ARelatedWorldInfo* Info = WorldInfo.Get();
+	AActor* Owner = GetOwner();
+
+	if (!bCompactMovementPending || Info == nullptr)
+	{
+		return;
+	}
+
+	FRepMovement Movement = Owner->GetReplicatedMovement();
+
+	if (!CompactMovement.GetMovement(Movement))
+	{
+		return;
+	}
+
+	bCompactMovementPending = false;
+	Owner->SetReplicatedMovement(Movement);
+	RebaseReplicatedMovement();
+}
+
+void URelatedLocationComponent::RebaseReplicatedMovement()
+{
+	UWorld* World = GetWorld();
+	const FIntVector STORE_OriginLocation = World->OriginLocation;
+	World->OriginLocation = FIntVector::ZeroValue;
+	AActor_OnRep_ReplicatedMovement(STORE_OriginLocation);
+	World->OriginLocation = STORE_OriginLocation;
+}
@@ -44,6 +44,14 @@ void URelatedLocationComponent::AActor_OnRep_ReplicatedMovement(const FIntVector
 {
 	FRepMovement* LocalMovement = (FRepMovement*)&GetOwner()->GetReplicatedMovement();
 
+	// Translation is not known until the world info binds, keep the received location for BindWorldInfo
+	bMovementRebasePending = !WorldInfo.IsValid() && GetOwnerRole() != ROLE_Authority;
+
+	if (bMovementRebasePending)
+	{
+		PendingMovementLocation = LocalMovement->Location;
+	}
+
 	FIntVector Rebase = WorldTranslation - WorldOrigin;
 	LocalMovement->Location = URelatedWorldUtils::CONVERT_RelToWorld(Rebase, LocalMovement->Location);
 	GetOwner()->OnRep_ReplicatedMovement();
@@ -0,0 +1,226 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#include "RelatedNavigationSystem.h"
+#include "WorldDirector.h"
+
+#include "NavigationData.h"
+#include "AbstractNavData.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+
+/** Same as default ObservedPathsTickInterval of navigation data */
+static const float SharedPathObservationInterval = 0.5f;
+
+struct FSharedNavDataState
+{
+	/** Navigation systems which use the data */
+	int32 NumUsers = 0;
+	/** Frame the paths were last processed in, its template world never ticks the data and every instance may try */
+	uint64 LastTickFrame = 0;
+	float NextObservationTime = 0.f;
+};
+
+static TMap<const ANavigationData*, FSharedNavDataState> SharedNavDataStates;
+
+/** Path lists of navigation data are protected, they are reached through member pointers taken in a derived type */
+struct FSharedNavDataAccess : public ANavigationData
+{
+	static TArray<FNavPathWeakPtr>& GetObservedPaths(ANavigationData* NavData)
+	{
+		return NavData->*(&FSharedNavDataAccess::ObservedPaths);
+	}
+
+	static TArray<FNavPathRecalculationRequest>& GetRepathRequests(ANavigationData* NavData)
+	{
+		return NavData->*(&FSharedNavDataAccess::RepathRequests);
+	}
+
+	static void PurgeUnusedPaths(ANavigationData* NavData)
+	{
+		(NavData->*(&FSharedNavDataAccess::PurgeUnusedPaths))();
+	}
+};
+
+/**
+ * Replaces TickActor of the shared data. Paths are recalculated through navigation system of the querier world
+ * and get time stamp of that world, the template world of the data has its own clock which never runs
+ */
+static void ProcessSharedPaths(ANavigationData* NavData, FSharedNavDataState& State, float DeltaSeconds)
+{
+	TArray<FNavPathWeakPtr>& ObservedPaths = FSharedNavDataAccess::GetObservedPaths(NavData);
+	TArray<FNavPathRecalculationRequest>& RepathRequests = FSharedNavDataAccess::GetRepathRequests(NavData);
+
+	FSharedNavDataAccess::PurgeUnusedPaths(NavData);
+
+	State.NextObservationTime -= DeltaSeconds;
+
+	if (State.NextObservationTime <= 0.f && ObservedPaths.Num() > 0)
+	{
+		State.NextObservationTime = SharedPathObservationInterval;
+
+		for (int32 i = ObservedPaths.Num() - 1; i >= 0; --i)
+		{
+			FNavPathSharedPtr Path = ObservedPaths[i].Pin();
+
+			if (!Path.IsValid())
+			{
+				ObservedPaths.RemoveAtSwap(i, 1, false);
+				continue;
+			}
+
+			switch (Path->TickPathObservation())
+			{
+				case EPathObservationResult::RequestRepath:
+					RepathRequests.Add(FNavPathRecalculationRequest(Path, ENavPathUpdateType::GoalMoved));
+					break;
+
+				case EPathObservationResult::NoLongerObserving:
+					ObservedPaths.RemoveAtSwap(i, 1, false);
+					break;
+
+				default:
+					break;
+			}
+		}
+	}
+
+	if (RepathRequests.Num() == 0)
+	{
+		return;
+	}
+
+	// Path updates may request new repaths, they are processed next frame
+	TArray<FNavPathRecalculationRequest> Requests = MoveTemp(RepathRequests);
+	RepathRequests.Reset();
+
+	for (const FNavPathRecalculationRequest& Request : Requests)
+	{
+		FNavPathSharedPtr Path = Request.Path.Pin();
+
+		if (!Path.IsValid())
+		{
+			continue;
+		}
+
+		const UObject* Querier = Path->GetQuerier();
+		const INavAgentInterface* NavAgent = Cast<const INavAgentInterface>(Querier);
+
+		if (NavAgent != nullptr && NavAgent->ShouldPostponePathUpdates())
+		{
+			RepathRequests.Add(Request);
+			continue;
+		}
+
+		UWorld* QuerierWorld = Querier != nullptr ? Querier->GetWorld() : nullptr;
+		UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(QuerierWorld);
+
+		// Querier world is already unloaded
+		if (NavSys == nullptr)
+		{
+			continue;
+		}
+
+		FPathFindingQuery Query(Path.ToSharedRef());
+		const FPathFindingResult Result = NavSys->FindPathSync(Query.SetPathInstanceToUpdate(Path));
+		Path->SetTimeStamp(QuerierWorld->GetTimeSeconds());
+
+		// Partial paths are still valid, the goal may get back on navmesh
+		if (Result.IsSuccessful() || Result.IsPartial())
+		{
+			Path->UpdateLastRepathGoalLocation();
+			Path->DoneUpdating(Request.Reason);
+		}
+		else
+		{
+			Path->RePathFailed();
+		}
+	}
+}
+
+void URelatedNavigationSystem::AddToWorld(UWorld& World, ANavigationData* SharedNavData)
+{
+	URelatedNavigationSystem* NavSys = NewObject<URelatedNavigationSystem>(&World);
+	NavSys->bAutoCreateNavigationData = false;
+
+	World.SetNavigationSystem(NavSys);
+	NavSys->InitializeForWorld(World, FNavigationSystemRunMode::GameMode);
+	NavSys->SetSharedNavData(SharedNavData);
+}
+
+ANavigationData* URelatedNavigationSystem::FindSharableNavData(UWorld& World)
+{
+	for (AActor* Actor : World.PersistentLevel->Actors)
+	{
+		ANavigationData* NavData = Cast<ANavigationData>(Actor);
+
+		if (NavData == nullptr || NavData->IsA<AAbstractNavData>())
+		{
+			continue;
+		}
+
+		// Dynamic obstacles and modifiers change the navmesh of one world, such templates keep a copy per instance
+		if (NavData->GetRuntimeGenerationMode() != ERuntimeGenerationType::Static)
+		{
+			UE_LOG(LogWorldDirector, Log, TEXT("%s of %s is generated at runtime, instances keep own copy of it"), *NavData->GetName(), *World.GetName());
+			return nullptr;
+		}
+
+		return NavData;
+	}
+
+	return nullptr;
+}
+
+void URelatedNavigationSystem::SetSharedNavData(ANavigationData* NavData)
+{
+	SharedNavData = NavData;
+	++SharedNavDataStates.FindOrAdd(NavData).NumUsers;
+
+	// Not registered through RegisterNavData, the data is owned by the template and has no generator
+	NavDataSet.AddUnique(NavData);
+	MainNavData = NavData;
+}
+
+void URelatedNavigationSystem::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (SharedNavData == nullptr)
+	{
+		return;
+	}
+
+	FSharedNavDataState& State = SharedNavDataStates.FindChecked(SharedNavData);
+
+	// Paths of every instance are processed once per frame by the first instance that ticks
+	if (State.LastTickFrame != GFrameCounter)
+	{
+		State.LastTickFrame = GFrameCounter;
+		ProcessSharedPaths(SharedNavData, State, DeltaSeconds);
+	}
+}
+
+void URelatedNavigationSystem::CleanUp(const FNavigationSystem::ECleanupMode Mode)
+{
+	// Other instances may still use the shared data
+	if (SharedNavData != nullptr)
+	{
+		FSharedNavDataState& State = SharedNavDataStates.FindChecked(SharedNavData);
+
+		if (--State.NumUsers == 0)
+		{
+			SharedNavDataStates.Remove(SharedNavData);
+		}
+
+		NavDataSet.Remove(SharedNavData);
+
+		if (MainNavData == SharedNavData)
+		{
+			MainNavData = nullptr;
+		}
+
+		SharedNavData = nullptr;
+	}
+
+	Super::CleanUp(Mode);
+}
@@ -0,0 +1,35 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavigationSystem.h"
+#include "RelatedNavigationSystem.generated.h"
+
+class ANavigationData;
+
+/**
+ * Navigation system of a world instance which uses navigation data of its template.
+ * Only data with static runtime generation is shared, it is never rebuilt by any world
+ */
+UCLASS(Transient)
+class URelatedNavigationSystem : public UNavigationSystemV1
+{
+	GENERATED_BODY()
+
+public:
+	/** Create navigation system for the world and make it use the shared navigation data */
+	static void AddToWorld(UWorld& World, ANavigationData* SharedNavData);
+
+	/** Returns first navigation data of the world if it can be shared with its instances, NULL if it is generated at runtime */
+	static ANavigationData* FindSharableNavData(UWorld& World);
+
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void CleanUp(const FNavigationSystem::ECleanupMode Mode) override;
+
+private:
+	void SetSharedNavData(ANavigationData* NavData);
+
+	UPROPERTY()
+		ANavigationData* SharedNavData;
+};
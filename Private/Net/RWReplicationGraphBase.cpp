@@ -3,6 +3,16 @@
 #include "Net/RwReplicationGraphBase.h"
 #include "WorldDirector.h"
 #include "RelatedWorld.h"
+#include "RelatedWorldInfo.h"
+
+DECLARE_CYCLE_STAT(TEXT("Domain Node Gather"), STAT_RelatedWorld_DomainGather, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("Domain Node Add Actor"), STAT_RelatedWorld_DomainAddActor, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("World Router Gather"), STAT_RelatedWorld_RouterGather, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("World Router Add Actor"), STAT_RelatedWorld_RouterAddActor, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("World Info Gather"), STAT_RelatedWorld_WorldInfoGather, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("Global Grid Prepare"), STAT_RelatedWorld_GlobalGridPrepare, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("Global Grid Gather"), STAT_RelatedWorld_GlobalGridGather, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("Replicate Actors Pending"), STAT_RelatedWorld_ReplicatePending, STATGROUP_RelatedWorld);
 
 void UReplicationGraphNode_Proxy::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
 {
@@ -49,9 +59,11 @@ T* UReplicationGraphNode_WorldRouter::CreateRoutedNodeTemplate()
 
 void UReplicationGraphNode_Domain::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
 {
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_DomainAddActor);
+
 	URelatedWorld* rWorld = UWorldDirector::Get()->GetRelatedWorldFromActor(ActorInfo.Actor);
 
-	if ((rWorld != nullptr && NodeDomain == (uint8)rWorld->GetWorldDomain())
+	if ((rWorld != nullptr && NodeDomain == (uint8)rWorld->GetReplicationDomain())
 		|| (rWorld == nullptr && NodeDomain == 0))
 	{
 		for (UReplicationGraphNode* ChildNode : AllChildNodes)
@@ -97,6 +109,8 @@ bool UReplicationGraphNode_Domain::NotifyRemoveNetworkActor(const FNewReplicated
 
 void UReplicationGraphNode_Domain::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
 {
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_DomainGather);
+
 	for (int32 i = 0; i < Params.Viewers.Num(); ++i)
 	{
 		FNetViewer* Viewer = (FNetViewer*)&Params.Viewers[i];
@@ -123,6 +137,8 @@ void UReplicationGraphNode_Domain::GatherActorListsForConnection(const FConnecti
 
 void UReplicationGraphNode_WorldRouter::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
 {
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_RouterAddActor);
+
 	URelatedWorld* rWorld = UWorldDirector::Get()->GetRelatedWorldFromActor(ActorInfo.Actor);
 
 	if (rWorld != nullptr)
@@ -193,6 +209,8 @@ bool UReplicationGraphNode_WorldRouter::NotifyRemoveNetworkActor(const FNewRepli
 
 void UReplicationGraphNode_WorldRouter::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
 {
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_RouterGather);
+
 	for (int32 i = 0; i < Params.Viewers.Num(); ++i)
 	{
 		FNetViewer* Viewer = (FNetViewer*)&Params.Viewers[i];
@@ -214,8 +232,84 @@ void UReplicationGraphNode_WorldRouter::GatherActorListsForConnection(const FCon
 	}
 }
 
+UReplicationGraphNode_ActorList* UReplicationGraphNode_WorldInfo::CreateListNode()
+{
+	UReplicationGraphNode_ActorList* Node = NewObject<UReplicationGraphNode_ActorList>(this);
+	Node->Initialize(GraphGlobals);
+	return Node;
+}
+
+void UReplicationGraphNode_WorldInfo::AddWorldInfo(const FNewReplicatedActorInfo& ActorInfo, URelatedWorld* RelatedWorld)
+{
+	const bool bPublic = RelatedWorld->GetReplicationDomain() == EWorldDomain::WD_PUBLIC;
+	UReplicationGraphNode_ActorList*& Node = bPublic ? PublicWorldInfoNode : WorldInfoNodes.FindOrAdd(RelatedWorld);
+
+	if (Node == nullptr)
+	{
+		Node = CreateListNode();
+	}
+
+	Node->NotifyAddNetworkActor(ActorInfo);
+	InfoWorlds.Add(ActorInfo.Actor, bPublic ? nullptr : RelatedWorld);
+}
+
+void UReplicationGraphNode_WorldInfo::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+
+}
+
+bool UReplicationGraphNode_WorldInfo::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	URelatedWorld* RelatedWorld = nullptr;
+
+	if (!InfoWorlds.RemoveAndCopyValue(ActorInfo.Actor, RelatedWorld))
+	{
+		return false;
+	}
+
+	if (RelatedWorld == nullptr)
+	{
+		return PublicWorldInfoNode->NotifyRemoveNetworkActor(ActorInfo, bWarnIfNotFound);
+	}
+
+	// One info per world, so its node goes away with it
+	UReplicationGraphNode_ActorList* Node = nullptr;
+	WorldInfoNodes.RemoveAndCopyValue(RelatedWorld, Node);
+
+	return Node != nullptr;
+}
+
+void UReplicationGraphNode_WorldInfo::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_WorldInfoGather);
+
+	bool bPublicViewer = false;
+
+	for (int32 i = 0; i < Params.Viewers.Num(); ++i)
+	{
+		URelatedWorld* rWorld = UWorldDirector::Get()->GetRelatedWorldFromActor(Params.Viewers[i].ViewTarget);
+
+		if (rWorld == nullptr || rWorld->GetWorldDomain() != EWorldDomain::WD_ISOLATED)
+		{
+			bPublicViewer = true;
+		}
+
+		if (UReplicationGraphNode_ActorList* Node = WorldInfoNodes.FindRef(rWorld))
+		{
+			Node->GatherActorListsForConnection(Params);
+		}
+	}
+
+	if (bPublicViewer && PublicWorldInfoNode != nullptr)
+	{
+		PublicWorldInfoNode->GatherActorListsForConnection(Params);
+	}
+}
+
 void UReplicationGraphNode_GlobalGridSpatialization2D::PrepareForReplication()
 {
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_GlobalGridPrepare);
+
 	Super::PrepareForReplication();
 	//ToDo: Better use relative coordinate system with origin in player position
 	for (AActor* Actor : DynamicSpatializedActors)
@@ -248,6 +342,8 @@ bool UReplicationGraphNode_GlobalGridSpatialization2D::NotifyRemoveNetworkActor(
 
 void UReplicationGraphNode_GlobalGridSpatialization2D::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
 {
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_GlobalGridGather);
+
 	for (int32 i = 0; i < Params.Viewers.Num(); ++i)
 	{
 		FNetViewer* Viewer = (FNetViewer*)&Params.Viewers[i];
@@ -303,7 +399,7 @@ void URwReplicationGraphBase::InitGlobalActorClassSettings()
 		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
 	}
 
-	UWorldDirector::Get()->OnMoveActorToWorld.AddDynamic(this, &URwReplicationGraphBase::OnMoveActorToWorld);
+	UWorldDirector::Get()->OnMoveActorsToWorld.AddDynamic(this, &URwReplicationGraphBase::OnMoveActorsToWorld);
 }
 
 void URwReplicationGraphBase::InitGlobalGraphNodes()
@@ -313,6 +409,9 @@ void URwReplicationGraphBase::InitGlobalGraphNodes()
 	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
 	AddGlobalGraphNode(AlwaysRelevantNode);
 
+	WorldInfoNode = CreateNewNode<UReplicationGraphNode_WorldInfo>();
+	AddGlobalGraphNode(WorldInfoNode);
+
 	UReplicationGraphNode_GridSpatialization2D* GridNode = nullptr;
 	UReplicationGraphNode_WorldRouter* RouterNode = nullptr;
 
@@ -364,7 +463,12 @@ void URwReplicationGraphBase::InitConnectionGraphNodes(UNetReplicationGraphConne
 
 void URwReplicationGraphBase::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
 {
-	if (ActorInfo.Actor->bAlwaysRelevant)
+	// Always relevant only without the graph, here it follows the visibility of its world
+	if (ActorInfo.Actor->IsA<ARelatedWorldInfo>())
+	{
+		PendingWorldInfos.Add(ActorInfo.Actor);
+	}
+	else if (ActorInfo.Actor->bAlwaysRelevant)
 	{
 		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
 	}
@@ -374,11 +478,11 @@ void URwReplicationGraphBase::RouteAddNetworkActorToNodes(const FNewReplicatedAc
 	}
 	else
 	{
-		URelatedWorld* rWorld = UWorldDirector::Get()->GetRelatedWorldFromActor(ActorInfo.Actor);
+		URelatedWorld* rWorld = bInMoveBatch ? MoveBatchWorld : UWorldDirector::Get()->GetRelatedWorldFromActor(ActorInfo.Actor);
 
 		if (rWorld != nullptr)
 		{
-			EWorldDomain Domain = rWorld->GetWorldDomain();
+			EWorldDomain Domain = rWorld->GetReplicationDomain();
 			DomainNode[(uint8)Domain]->NotifyAddNetworkActor(ActorInfo);
 		}
 		else
@@ -388,18 +492,62 @@ void URwReplicationGraphBase::RouteAddNetworkActorToNodes(const FNewReplicatedAc
 	}
 }
 
-void URwReplicationGraphBase::OnMoveActorToWorld(AActor* InActor, URelatedWorld* OldWorld, URelatedWorld* NewWorld)
+void URwReplicationGraphBase::OnMoveActorsToWorld(const TArray<AActor*>& InActors, URelatedWorld* OldWorld, URelatedWorld* NewWorld)
 {
-	uint8 OldDomain = OldWorld ? (uint8)OldWorld->GetWorldDomain() : 0;
-	uint8 NewDomain = NewWorld ? (uint8)NewWorld->GetWorldDomain() : 0;
+	UReplicationGraphNode_Domain* OldDomainNode = DomainNode[OldWorld ? (uint8)OldWorld->GetReplicationDomain() : 0];
+	const uint8 NewDomain = NewWorld ? (uint8)NewWorld->GetReplicationDomain() : 0;
+
+	for (AActor* InActor : InActors)
+	{
+		OldDomainNode->NotifyRemoveNetworkActor(FNewReplicatedActorInfo(InActor), false);
+	}
 
-	DomainNode[OldDomain]->NotifyRemoveNetworkActor(FNewReplicatedActorInfo(InActor), false);
+	WorldChangePendingActors.Append(InActors);
+	WorldChangePendingDomains.Reserve(WorldChangePendingActors.Num());
 
-	WorldChangePendingActors.Add(InActor);
+	for (int32 i = 0; i < InActors.Num(); ++i)
+	{
+		WorldChangePendingDomains.Add(NewDomain);
+	}
+}
+
+void URwReplicationGraphBase::BeginMoveBatch(URelatedWorld* World)
+{
+	bInMoveBatch = true;
+	MoveBatchWorld = World;
+}
+
+void URwReplicationGraphBase::EndMoveBatch()
+{
+	bInMoveBatch = false;
+	MoveBatchWorld = nullptr;
 }
 
 int32 URwReplicationGraphBase::ServerReplicateActors(float DeltaSeconds)
 {
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_ReplicatePending);
+		CSV_SCOPED_TIMING_STAT(RelatedWorld, ReplicatePending);
+		ProcessPendingActors();
+	}
+
+	return Super::ServerReplicateActors(DeltaSeconds);
+}
+
+void URwReplicationGraphBase::ProcessPendingActors()
+{
+	for (AActor* Actor : PendingWorldInfos)
+	{
+		ARelatedWorldInfo* Info = Cast<ARelatedWorldInfo>(Actor);
+
+		if (IsValid(Info) && Info->GetRelatedWorld() != nullptr)
+		{
+			WorldInfoNode->AddWorldInfo(FNewReplicatedActorInfo(Info), Info->GetRelatedWorld());
+		}
+	}
+
+	PendingWorldInfos.Reset();
+
 	for (int32 i = ActorsWithoutConnection.Num() - 1; i >= 0; --i)
 	{
 		bool bRemove = false;
@@ -426,16 +574,14 @@ int32 URwReplicationGraphBase::ServerReplicateActors(float DeltaSeconds)
 		}
 	}
 
-	for (int32 i = WorldChangePendingActors.Num() - 1; i >= 0; --i)
+	for (int32 i = 0; i < WorldChangePendingActors.Num(); ++i)
 	{
 		if (AActor* Actor = WorldChangePendingActors[i])
 		{
-			URelatedWorld* rWorld = UWorldDirector::Get()->GetRelatedWorldFromActor(Actor);
-			uint8 Domain = rWorld ? (uint8)rWorld->GetWorldDomain() : 0;
-			DomainNode[Domain]->NotifyAddNetworkActor(FNewReplicatedActorInfo(Actor));
-			WorldChangePendingActors.RemoveAt(i, 1, false);
+			DomainNode[WorldChangePendingDomains[i]]->NotifyAddNetworkActor(FNewReplicatedActorInfo(Actor));
 		}
 	}
 
-	return Super::ServerReplicateActors(DeltaSeconds);
+	WorldChangePendingActors.Reset();
+	WorldChangePendingDomains.Reset();
 }
@@ -3,14 +3,38 @@
 #include "RelatedWorld.h"
 #include "WorldDirector.h"
 #include "Components/RelatedLocationComponent.h"
+#include "RelatedWorldInfo.h"
 
 #include "FxSystem.h"
 #include "InGamePerformanceTracker.h"
 #include "TickTaskManagerInterface.h"
 #include "Engine/WorldComposition.h"
+#include "EngineUtils.h"
 #include "Kismet/GameplayStatics.h"
 #include "Components/SceneCaptureComponent.h"
 #include "GameFramework/Character.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Begin Tick"), STAT_RelatedWorld_BeginTick, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("Prepare Tick"), STAT_RelatedWorld_PrepareTick, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("End Tick"), STAT_RelatedWorld_EndTick, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("TG_PrePhysics"), STAT_RelatedWorld_TG_PrePhysics, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("TG_StartPhysics"), STAT_RelatedWorld_TG_StartPhysics, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("TG_DuringPhysics"), STAT_RelatedWorld_TG_DuringPhysics, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("TG_EndPhysics"), STAT_RelatedWorld_TG_EndPhysics, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("TG_PostPhysics"), STAT_RelatedWorld_TG_PostPhysics, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("TG_PostUpdateWork"), STAT_RelatedWorld_TG_PostUpdateWork, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("TG_LastDemotable"), STAT_RelatedWorld_TG_LastDemotable, STATGROUP_RelatedWorld);
+
+/** Folded time above MaxUndilatedFrameTime is split into at most this many steps, the rest is dropped */
+static const int32 MaxFoldedTickSteps = 8;
+
+#if STATS
+/** Dynamic stats are never freed, so unloaded worlds give their stat ids to the next loaded world */
+static TArray<TStatId> WorldStatIds;
+static TArray<int32> FreeWorldStatSlots;
+#endif
 
 FVector URelatedWorldUtils::ActorLocationToWorldLocation(AActor* InActor)
 {
@@ -74,6 +98,110 @@ FVector URelatedWorldUtils::CONVERT_RelToRel(const FIntVector& From, const FIntV
 	);
 }
 
+FRelatedWorldSector URelatedWorldUtils::CONVERT_RelToSector(const FRelatedWorldSector& WorldSector, const FVector& Location)
+{
+	return WorldSector + Location;
+}
+
+FVector URelatedWorldUtils::CONVERT_SectorToRel(const FRelatedWorldSector& WorldSector, const FRelatedWorldSector& Position)
+{
+	return Position - WorldSector;
+}
+
+FVector URelatedWorldUtils::CONVERT_RelToRelSector(const FRelatedWorldSector& From, const FRelatedWorldSector& To, const FVector& Location)
+{
+	return (From - To) + Location;
+}
+
+static_assert(sizeof(FVector) == 3 * sizeof(float), "Batch conversion expects tightly packed FVector");
+
+/** Add the same offset to every location, the array is processed as floats, twelve floats are four locations */
+static void OffsetLocations(TArrayView<const FVector> In, const FVector& Offset, TArrayView<FVector> Out)
+{
+	check(In.Num() == Out.Num());
+
+	const int32 Num = In.Num();
+
+	if (Num == 0)
+	{
+		return;
+	}
+
+	const float* Src = &In[0].X;
+	float* Dst = &Out[0].X;
+	const int32 NumSimdFloats = (Num / 4) * 12;
+
+	// XYZ pattern repeats every three registers
+	const VectorRegister Offset0 = MakeVectorRegister(Offset.X, Offset.Y, Offset.Z, Offset.X);
+	const VectorRegister Offset1 = MakeVectorRegister(Offset.Y, Offset.Z, Offset.X, Offset.Y);
+	const VectorRegister Offset2 = MakeVectorRegister(Offset.Z, Offset.X, Offset.Y, Offset.Z);
+
+	for (int32 i = 0; i < NumSimdFloats; i += 12)
+	{
+		const VectorRegister A = VectorLoad(Src + i);
+		const VectorRegister B = VectorLoad(Src + i + 4);
+		const VectorRegister C = VectorLoad(Src + i + 8);
+
+		VectorStore(VectorAdd(A, Offset0), Dst + i);
+		VectorStore(VectorAdd(B, Offset1), Dst + i + 4);
+		VectorStore(VectorAdd(C, Offset2), Dst + i + 8);
+	}
+
+	for (int32 Index = NumSimdFloats / 3; Index < Num; ++Index)
+	{
+		Out[Index] = In[Index] + Offset;
+	}
+}
+
+static void OffsetTransforms(TArrayView<const FTransform> In, const FVector& Offset, TArrayView<FTransform> Out)
+{
+	check(In.Num() == Out.Num());
+
+	for (int32 i = 0; i < In.Num(); ++i)
+	{
+		Out[i] = In[i];
+		Out[i].AddToTranslation(Offset);
+	}
+}
+
+void URelatedWorldUtils::CONVERT_RelToWorldBatch(TArrayView<const FVector> In, const FIntVector& Translation, TArrayView<FVector> Out)
+{
+	OffsetLocations(In, FVector(Translation), Out);
+}
+
+void URelatedWorldUtils::CONVERT_WorldToRelBatch(TArrayView<const FVector> In, const FIntVector& Translation, TArrayView<FVector> Out)
+{
+	OffsetLocations(In, -FVector(Translation), Out);
+}
+
+void URelatedWorldUtils::CONVERT_RelToRelBatch(TArrayView<const FVector> In, const FIntVector& From, const FIntVector& To, TArrayView<FVector> Out)
+{
+	OffsetLocations(In, FVector(From - To), Out);
+}
+
+void URelatedWorldUtils::CONVERT_RelToWorldBatch(TArrayView<const FTransform> In, const FIntVector& Translation, TArrayView<FTransform> Out)
+{
+	OffsetTransforms(In, FVector(Translation), Out);
+}
+
+void URelatedWorldUtils::CONVERT_WorldToRelBatch(TArrayView<const FTransform> In, const FIntVector& Translation, TArrayView<FTransform> Out)
+{
+	OffsetTransforms(In, -FVector(Translation), Out);
+}
+
+void URelatedWorldUtils::RelatedWorldLocationsToWorldLocations(URelatedWorld* RelatedWorld, TArrayView<const FVector> In, TArrayView<FVector> Out)
+{
+	// Rebase onto zero origin, translate and rebase onto the persistent world origin in one integer offset
+	const FIntVector Offset = RelatedWorld->Context()->World()->OriginLocation + RelatedWorld->GetWorldTranslation() - RelatedWorld->GetWorld()->OriginLocation;
+	OffsetLocations(In, FVector(Offset), Out);
+}
+
+void URelatedWorldUtils::WorldLocationsToRelatedWorldLocations(URelatedWorld* RelatedWorld, TArrayView<const FVector> In, TArrayView<FVector> Out)
+{
+	const FIntVector Offset = RelatedWorld->GetWorld()->OriginLocation - RelatedWorld->GetWorldTranslation() - RelatedWorld->Context()->World()->OriginLocation;
+	OffsetLocations(In, FVector(Offset), Out);
+}
+
 URelatedLocationComponent* URelatedWorldUtils::GetRelatedLocationComponent(AActor* InActor)
 {
 	return Cast<URelatedLocationComponent>(InActor->GetComponentByClass(URelatedLocationComponent::StaticClass()));
@@ -130,7 +258,28 @@ AGameStateBase* URelatedWorldUtils::GetGameState(const UObject* WorldContextObje
 
 bool URelatedWorld::IsTickable() const
 {
-	return Context() ? true : false;
+	if (Context() == nullptr)
+	{
+		return false;
+	}
+
+	const ERelatedWorldTickLOD TickLOD = GetTickLOD();
+	return TickLOD != ERelatedWorldTickLOD::TL_PAUSED && TickLOD != ERelatedWorldTickLOD::TL_HIBERNATED;
+}
+
+ERelatedWorldTickLOD URelatedWorld::GetTickLOD() const
+{
+	if (bHibernated)
+	{
+		return ERelatedWorldTickLOD::TL_HIBERNATED;
+	}
+
+	if (TickPolicy == ERelatedWorldTickPolicy::TP_ALWAYS || ViewerCount > 0)
+	{
+		return ERelatedWorldTickLOD::TL_FULL;
+	}
+
+	return ReferenceCount > 0 ? ERelatedWorldTickLOD::TL_REDUCED : ERelatedWorldTickLOD::TL_PAUSED;
 }
 
 UWorld* URelatedWorld::GetWorld() const
@@ -140,6 +289,76 @@ UWorld* URelatedWorld::GetWorld() const
 
 void URelatedWorld::Tick(float DeltaSeconds)
 {
+	FScopeCycleCounter WorldCycleCounter(StatId);
+#if ENGINE_MINOR_VERSION >= 26
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(*TraceName, RelatedWorldChannel);
+#endif
+	FMemMark Mark(FMemStack::Get());
+	const double StartTime = FPlatformTime::Seconds();
+
+	if (!ConsumeTickDelta(DeltaSeconds))
+	{
+		return;
+	}
+
+	for (int32 Step = 0; Step < TickSteps; ++Step)
+	{
+		TickStep(TickStepDeltaSeconds);
+	}
+
+	UpdateTickCost((FPlatformTime::Seconds() - StartTime) * 1000.f);
+}
+
+bool URelatedWorld::ConsumeTickDelta(float DeltaSeconds)
+{
+	// Fold skipped time into the delta of the next reduced rate tick
+	PendingDeltaSeconds += DeltaSeconds;
+
+	if (GetTickLOD() == ERelatedWorldTickLOD::TL_REDUCED && PendingDeltaSeconds < ReferencedTickInterval)
+	{
+		return false;
+	}
+
+	DeltaSeconds = PendingDeltaSeconds;
+	PendingDeltaSeconds = 0.f;
+
+	if (FixedTimestep <= 0.f)
+	{
+		// FixupDeltaSeconds clamps every step to MaxUndilatedFrameTime, so folded time is split instead of clamped
+		const float MaxStepDeltaSeconds = FMath::Max(Context()->World()->GetWorldSettings()->MaxUndilatedFrameTime, KINDA_SMALL_NUMBER);
+		TickSteps = FMath::Clamp(FMath::CeilToInt(DeltaSeconds / MaxStepDeltaSeconds), 1, MaxFoldedTickSteps);
+		TickStepDeltaSeconds = FMath::Min(DeltaSeconds / TickSteps, MaxStepDeltaSeconds);
+		return true;
+	}
+
+	FixedTimestepAccumulator += DeltaSeconds;
+	TickSteps = FMath::Min(FMath::FloorToInt(FixedTimestepAccumulator / FixedTimestep), MaxFixedSubsteps);
+	TickStepDeltaSeconds = FixedTimestep;
+	FixedTimestepAccumulator -= TickSteps * FixedTimestep;
+
+	// Time which does not fit into max substeps is dropped, otherwise the world would never catch up after hitch
+	FixedTimestepAccumulator = FMath::Min(FixedTimestepAccumulator, FixedTimestep);
+
+	return TickSteps > 0;
+}
+
+void URelatedWorld::TickStep(float DeltaSeconds, bool bClampDelta)
+{
+	if (!BeginTick(DeltaSeconds, bClampDelta))
+	{
+		return;
+	}
+
+	PrepareTick();
+	TickActors();
+	EndTick();
+}
+
+bool URelatedWorld::BeginTick(float DeltaSeconds, bool bClampDelta)
+{
+	check(IsInGameThread());
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_BeginTick);
+
 	ELevelTick TickType = LEVELTICK_All;
 	UWorld* World = Context()->World();
 	AWorldSettings* Info = World->GetWorldSettings();
@@ -147,19 +366,21 @@ void URelatedWorld::Tick(float DeltaSeconds)
 
 	if (GIntraFrameDebuggingGameThread)
 	{
-		return;
+		return false;
 	}
 
 	FWorldDelegates::OnWorldTickStart.Broadcast(World, TickType, DeltaSeconds);
 
-	//Tick game and other thread trackers.
-	for (int32 Tracker = 0; Tracker < (int32)EInGamePerfTrackers::Num; ++Tracker)
+	if (TickProfile == ERelatedWorldTickProfile::TPR_FULL)
 	{
-		World->PerfTrackers->GetInGamePerformanceTracker((EInGamePerfTrackers)Tracker, EInGamePerfTrackerThreads::GameThread).Tick();
-		World->PerfTrackers->GetInGamePerformanceTracker((EInGamePerfTrackers)Tracker, EInGamePerfTrackerThreads::OtherThread).Tick();
+		//Tick game and other thread trackers.
+		for (int32 Tracker = 0; Tracker < (int32)EInGamePerfTrackers::Num; ++Tracker)
+		{
+			World->PerfTrackers->GetInGamePerformanceTracker((EInGamePerfTrackers)Tracker, EInGamePerfTrackerThreads::GameThread).Tick();
+			World->PerfTrackers->GetInGamePerformanceTracker((EInGamePerfTrackers)Tracker, EInGamePerfTrackerThreads::OtherThread).Tick();
+		}
 	}
 
-	FMemMark Mark(FMemStack::Get());
 	World->bInTick = true;
 	bool bIsPaused = GetWorld()->IsPaused() || World->IsPaused();
 
@@ -179,7 +400,7 @@ void URelatedWorld::Tick(float DeltaSeconds)
 	DeltaSeconds *= Info->GetEffectiveTimeDilation();
 
 	// Handle clamping of time to an acceptable value
-	const float GameDeltaSeconds = Info->FixupDeltaSeconds(DeltaSeconds, RealDeltaSeconds);
+	const float GameDeltaSeconds = bClampDelta ? Info->FixupDeltaSeconds(DeltaSeconds, RealDeltaSeconds) : DeltaSeconds;
 	check(GameDeltaSeconds >= 0.0f);
 
 	DeltaSeconds = GameDeltaSeconds;
@@ -213,7 +434,8 @@ void URelatedWorld::Tick(float DeltaSeconds)
 		NavigationSystem->Tick(DeltaSeconds);
 	}
 
-	bool bDoingActorTicks =
+	// The net driver is shared with the persistent world, so it is only read here on the game thread
+	bDoingActorTicks =
 		(TickType != LEVELTICK_TimeOnly)
 		&& !bIsPaused
 		&& (!GetWorld()->NetDriver
@@ -240,20 +462,57 @@ void URelatedWorld::Tick(float DeltaSeconds)
 #endif
 	}
 
+	CurrentTickType = TickType;
+	CurrentDeltaSeconds = DeltaSeconds;
+	bCurrentTickPaused = bIsPaused;
+
+	return true;
+}
+
+void URelatedWorld::PrepareTick()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_PrepareTick);
+
+	UWorld* World = Context()->World();
 	const TArray<FLevelCollection>& LevelCollections = World->GetLevelCollections();
 
-	for (int32 i = 0; i < LevelCollections.Num(); ++i)
+	if (bLevelsToTickDirty || CollectionLevelsToTick.Num() != LevelCollections.Num())
 	{
-		// Build a list of levels from the collection that are also in the world's Levels array.
-		// Collections may contain levels that aren't loaded in the world at the moment.
-		TArray<ULevel*> LevelsToTick;
-		for (ULevel* CollectionLevel : LevelCollections[i].GetLevels())
+		bLevelsToTickDirty = false;
+		CollectionLevelsToTick.SetNum(LevelCollections.Num());
+
+		for (int32 i = 0; i < LevelCollections.Num(); ++i)
 		{
-			if (World->GetLevels().Contains(CollectionLevel))
+			// Build a list of levels from the collection that are also in the world's Levels array.
+			// Collections may contain levels that aren't loaded in the world at the moment.
+			TArray<ULevel*>& LevelsToTick = CollectionLevelsToTick[i];
+			LevelsToTick.Reset();
+
+			for (ULevel* CollectionLevel : LevelCollections[i].GetLevels())
 			{
-				LevelsToTick.Add(CollectionLevel);
+				if (World->GetLevels().Contains(CollectionLevel))
+				{
+					LevelsToTick.Add(CollectionLevel);
+				}
 			}
 		}
+	}
+}
+
+void URelatedWorld::TickActors()
+{
+	check(IsInGameThread());
+
+	UWorld* World = Context()->World();
+	const ELevelTick TickType = CurrentTickType;
+	const float DeltaSeconds = CurrentDeltaSeconds;
+	const bool bIsPaused = bCurrentTickPaused;
+
+	const TArray<FLevelCollection>& LevelCollections = World->GetLevelCollections();
+
+	for (int32 i = 0; i < LevelCollections.Num(); ++i)
+	{
+		const TArray<ULevel*>& LevelsToTick = CollectionLevelsToTick[i];
 
 		// Set up context on the world for this level collection
 		FScopedLevelCollectionContextSwitch LevelContext(i, World);
@@ -267,6 +526,7 @@ void URelatedWorld::Tick(float DeltaSeconds)
 			FTickTaskManagerInterface::Get().StartFrame(World, DeltaSeconds, TickType, LevelsToTick);
 
 			{
+				SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_TG_PrePhysics);
 				World->RunTickGroup(TG_PrePhysics, true);
 			}
 
@@ -275,17 +535,21 @@ void URelatedWorld::Tick(float DeltaSeconds)
 			World->bInTick = true;
 
 			{
+				SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_TG_StartPhysics);
 				World->RunTickGroup(TG_StartPhysics, true);
 			}
 			{
+				SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_TG_DuringPhysics);
 				World->RunTickGroup(TG_DuringPhysics, false); // No wait here, we should run until idle though. We don't care if all of the async ticks are done before we start running post-phys stuff
 			}
 
 			World->TickGroup = TG_EndPhysics; // set this here so the current tick group is correct during collision notifies, though I am not sure it matters. 'cause of the false up there^^^
 			{
+				SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_TG_EndPhysics);
 				World->RunTickGroup(TG_EndPhysics, true);
 			}
 			{
+				SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_TG_PostPhysics);
 				World->RunTickGroup(TG_PostPhysics, true);
 			}
 
@@ -317,31 +581,47 @@ void URelatedWorld::Tick(float DeltaSeconds)
 		if (bDoingActorTicks)
 		{
 			{
+				SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_TG_PostUpdateWork);
 				World->RunTickGroup(TG_PostUpdateWork, true);
 			}
 			{
+				SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_TG_LastDemotable);
 				World->RunTickGroup(TG_LastDemotable, true);
 			}
 
 			FTickTaskManagerInterface::Get().EndFrame();
 		}
 	}
+}
+
+void URelatedWorld::EndTick()
+{
+	check(IsInGameThread());
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_EndTick);
+
+	UWorld* World = Context()->World();
+	const ELevelTick TickType = CurrentTickType;
+	const float DeltaSeconds = CurrentDeltaSeconds;
+	const bool bIsPaused = bCurrentTickPaused;
 
 	if (bDoingActorTicks)
 	{
 		FWorldDelegates::OnWorldPostActorTick.Broadcast(World, TickType, DeltaSeconds);
 	}
 
-	if (World->Scene)
+	if (TickProfile == ERelatedWorldTickProfile::TPR_FULL)
 	{
-		// Update SpeedTree wind objects.
-		World->Scene->UpdateSpeedTreeWind(World->TimeSeconds);
-	}
+		if (World->Scene)
+		{
+			// Update SpeedTree wind objects.
+			World->Scene->UpdateSpeedTreeWind(World->TimeSeconds);
+		}
 
-	// Tick the FX system.
-	if (!bIsPaused && World->FXSystem != nullptr)
-	{
-		World->FXSystem->Tick(DeltaSeconds);
+		// Tick the FX system.
+		if (!bIsPaused && World->FXSystem != nullptr)
+		{
+			World->FXSystem->Tick(DeltaSeconds);
+		}
 	}
 
 #if WITH_EDITOR
@@ -374,6 +654,11 @@ void URelatedWorld::Tick(float DeltaSeconds)
 	// Dump the viewpoints with which we were rendered last frame. They will be updated when the world is next rendered.
 	World->ViewLocationsRenderedLastFrame.Reset();
 
+	if (TickProfile != ERelatedWorldTickProfile::TPR_FULL)
+	{
+		return;
+	}
+
 	UWorld* WorldParam = World;
 	ENQUEUE_RENDER_COMMAND(TickInGamePerfTrackersRT)(
 		[WorldParam](FRHICommandList& RHICmdList)
@@ -393,6 +678,100 @@ void URelatedWorld::Tick(float DeltaSeconds)
 	}
 }
 
+void URelatedWorld::SetContext(FWorldContext* Context)
+{
+	_Context = Context;
+
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	LevelAddedHandle.Reset();
+	LevelRemovedHandle.Reset();
+
+	CollectionLevelsToTick.Empty();
+	bLevelsToTickDirty = true;
+
+#if STATS
+	if (_Context == nullptr && StatSlot != 0)
+	{
+		FreeWorldStatSlots.Add(StatSlot);
+		StatSlot = 0;
+	}
+#endif
+
+	if (_Context != nullptr)
+	{
+		LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &URelatedWorld::HandleLevelsChanged);
+		LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &URelatedWorld::HandleLevelsChanged);
+	}
+}
+
+void URelatedWorld::SetFixedTickRate(float TickRate, int32 MaxSubsteps)
+{
+	FixedTimestep = TickRate > 0.f ? 1.f / TickRate : 0.f;
+	MaxFixedSubsteps = FMath::Max(MaxSubsteps, 1);
+	FixedTimestepAccumulator = 0.f;
+}
+
+void URelatedWorld::SetWorldName(FName Name)
+{
+	WorldName = Name;
+	TraceName = FString::Printf(TEXT("RelatedWorld %s"), *WorldName.ToString());
+
+#if STATS
+	if (StatSlot == 0)
+	{
+		if (FreeWorldStatSlots.Num() > 0)
+		{
+			StatSlot = FreeWorldStatSlots.Pop(false);
+		}
+		else
+		{
+			StatSlot = WorldStatIds.Num() + 1;
+			WorldStatIds.Add(FDynamicStats::CreateStatId<FStatGroup_STATGROUP_RelatedWorld>(FString::Printf(TEXT("RelatedWorld Slot %d"), StatSlot)));
+		}
+
+		StatId = WorldStatIds[StatSlot - 1];
+	}
+
+	UE_LOG(LogWorldDirector, Log, TEXT("Related world %s is shown as RelatedWorld Slot %d in stats"), *WorldName.ToString(), StatSlot);
+#endif
+}
+
+#if STATS
+static void DumpRelatedWorldStatSlots(FOutputDevice& Ar)
+{
+	TArray<URelatedWorld*> RelatedWorlds = UWorldDirector::Get()->GetRelatedWorlds();
+	RelatedWorlds.Sort([](const URelatedWorld& A, const URelatedWorld& B) { return A.GetStatSlot() < B.GetStatSlot(); });
+
+	for (URelatedWorld* rWorld : RelatedWorlds)
+	{
+		Ar.Logf(TEXT("RelatedWorld Slot %-4d %-32s %8.3f ms"), rWorld->GetStatSlot(), *rWorld->GetWorldName().ToString(), rWorld->GetTickCost());
+	}
+}
+
+static FAutoConsoleCommandWithOutputDevice RelatedWorldStatSlotsCommand(
+	TEXT("RelatedWorld.StatSlots"),
+	TEXT("Prints which related world every RelatedWorld Slot of stat RelatedWorld belongs to"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&DumpRelatedWorldStatSlots));
+#endif
+
+void URelatedWorld::UpdateTickCost(float Cost)
+{
+	TickCost = FMath::Lerp(TickCost, Cost, 0.2f);
+
+#if CSV_PROFILER
+	FCsvProfiler::RecordCustomStat(WorldName, CSV_CATEGORY_INDEX(RelatedWorld), Cost, ECsvCustomStatOp::Set);
+#endif
+}
+
+void URelatedWorld::HandleLevelsChanged(ULevel* Level, UWorld* World)
+{
+	if (Context() != nullptr && World == Context()->World())
+	{
+		bLevelsToTickDirty = true;
+	}
+}
+
 void URelatedWorld::HandleBeginPlay()
 {
 	AGameModeBase* GM = GetWorld()->GetAuthGameMode();
@@ -417,7 +796,7 @@ AActor* URelatedWorld::SpawnActor(UClass* Class, const FTransform& SpawnTransfor
 
 	AActor* SpawnedActor = WorldToSpawn->SpawnActor<AActor>(Class, SpawnTransform, SpawnParams);
 
-	if (SpawnedActor->GetNetMode() == NM_DedicatedServer && IsNetworkedWorld())
+	if (SpawnedActor != nullptr && SpawnedActor->GetNetMode() == NM_DedicatedServer && IsNetworkedWorld())
 	{
 		URelatedLocationComponent* LocationComponent = NewObject<URelatedLocationComponent>(SpawnedActor, TEXT("LocationComponent"), RF_Transient);
 		LocationComponent->RegisterComponent();
@@ -436,6 +815,139 @@ void URelatedWorld::SetWorldOrigin(FIntVector NewOrigin)
 void URelatedWorld::TranslateWorld(FIntVector NewTranslation)
 {
 	WorldTranslation = NewTranslation;
+	WorldSector = FRelatedWorldSector::FromTranslation(NewTranslation);
+	bTranslationClamped = false;
+	++TranslationVersion;
+	UWorldDirector::Get()->UpdateSpatialIndex(this);
+
+	if (WorldInfo.IsValid())
+	{
+		WorldInfo->SetWorldSector(WorldSector);
+	}
 
 	OnWorldTranslationChanged.Broadcast(WorldTranslation);
 }
+
+void URelatedWorld::TranslateWorldSector(const FRelatedWorldSector& NewSector)
+{
+	WorldSector = NewSector;
+	WorldSector.Normalize();
+	++TranslationVersion;
+
+	bTranslationClamped = !WorldSector.ToTranslation(WorldTranslation);
+
+	if (bTranslationClamped)
+	{
+		UE_LOG(LogWorldDirector, Verbose, TEXT("World %s is placed at %s, its 32-bit translation is clamped"), *WorldName.ToString(), *WorldSector.ToString());
+	}
+
+	UWorldDirector::Get()->UpdateSpatialIndex(this);
+
+	if (WorldInfo.IsValid())
+	{
+		WorldInfo->SetWorldSector(WorldSector);
+	}
+
+	OnWorldTranslationChanged.Broadcast(WorldTranslation);
+}
+
+EWorldDomain URelatedWorld::GetReplicationDomain() const
+{
+	if (Domain == EWorldDomain::WD_PUBLIC && (FMath::Abs(WorldTranslation.X) > WORLD_MAX || FMath::Abs(WorldTranslation.Y) > WORLD_MAX))
+	{
+		return EWorldDomain::WD_PRIVATE;
+	}
+
+	return Domain;
+}
+
+FBox URelatedWorld::GetWorldBounds() const
+{
+	return LocalBounds.IsValid ? LocalBounds.ShiftBy(FVector(WorldTranslation)) : LocalBounds;
+}
+
+void URelatedWorld::SetWorldBounds(const FBox& Bounds)
+{
+	LocalBounds = Bounds;
+	UWorldDirector::Get()->UpdateSpatialIndex(this);
+
+	if (WorldInfo.IsValid())
+	{
+		WorldInfo->SetWorldBounds(LocalBounds);
+	}
+}
+
+bool URelatedWorld::Hibernate()
+{
+	if (bHibernated)
+	{
+		return true;
+	}
+
+	if (Context() == nullptr || Domain == EWorldDomain::WD_PUBLIC)
+	{
+		return false;
+	}
+
+	bHibernated = true;
+	HibernationStartTime = FPlatformTime::Seconds();
+	PendingDeltaSeconds = 0.f;
+
+	if (IsNetworkedWorld())
+	{
+		for (FActorIterator ActorIt(Context()->World()); ActorIt; ++ActorIt)
+		{
+			AActor* Actor = *ActorIt;
+
+			if (Actor->GetIsReplicated() && Actor->NetDormancy != DORM_DormantAll)
+			{
+				HibernatedActorsDormancy.Add(Actor, Actor->NetDormancy);
+				Actor->SetNetDormancy(DORM_DormantAll);
+			}
+		}
+	}
+
+	return true;
+}
+
+void URelatedWorld::Wake(float MaxCatchUpTime, int32 CatchUpSteps)
+{
+	if (!bHibernated)
+	{
+		return;
+	}
+
+	bHibernated = false;
+	EmptyTime = 0.f;
+
+	for (const TPair<TWeakObjectPtr<AActor>, TEnumAsByte<ENetDormancy>>& Pair : HibernatedActorsDormancy)
+	{
+		if (AActor* Actor = Pair.Key.Get())
+		{
+			Actor->SetNetDormancy(Pair.Value);
+		}
+	}
+
+	HibernatedActorsDormancy.Empty();
+
+	// Ticks can't be nested into the tick of another world, so catch up is done by the director on the next frame
+	const float HibernatedTime = FPlatformTime::Seconds() - HibernationStartTime;
+	PendingCatchUpTime = FMath::Min(HibernatedTime, FMath::Max(MaxCatchUpTime, 0.f));
+	PendingCatchUpSteps = PendingCatchUpTime > 0.f ? FMath::Max(CatchUpSteps, 1) : 0;
+}
+
+void URelatedWorld::CatchUp()
+{
+	const int32 Steps = PendingCatchUpSteps;
+	const float StepDeltaSeconds = PendingCatchUpTime / Steps;
+
+	PendingCatchUpSteps = 0;
+	PendingCatchUpTime = 0.f;
+
+	// Catch up steps are already clamped by Wake, they bypass tick LOD, fixed timestep and FixupDeltaSeconds
+	for (int32 Step = 0; Step < Steps && Context() != nullptr; ++Step)
+	{
+		FMemMark Mark(FMemStack::Get());
+		TickStep(StepDeltaSeconds, false);
+	}
+}
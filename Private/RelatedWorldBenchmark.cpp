@@ -0,0 +1,751 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#include "WorldDirector.h"
+#include "RelatedWorld.h"
+#include "RelatedWorldRepMovement.h"
+
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "Engine/SimulatedClientNetConnection.h"
+#include "GameFramework/DefaultPawn.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/BitWriter.h"
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ * Headless micro benchmarks of the module, results are written into CSV file
+ *
+ * Usage: RelatedWorld.Benchmark [Map=/Game/Maps/Map] [Actors=0,100,1000] [Worlds=1,10,50] [Connections=1,10,50] [Iterations=100] [Output=File.csv] [Quit]
+ * Example: UE4Server Project -nullrhi -ExecCmds="RelatedWorld.Benchmark Map=/Game/Maps/Dungeon Quit"
+ */
+class FRelatedWorldBenchmark
+{
+public:
+	FRelatedWorldBenchmark(UWorld* InWorld, const TArray<FString>& Args)
+		: World(InWorld)
+		, Director(UWorldDirector::Get())
+		, Iterations(100)
+		, ActorClass(ADefaultPawn::StaticClass())
+		, bQuit(false)
+	{
+		const FString InArgs = FString::Join(Args, TEXT(" "));
+
+		FParse::Value(*InArgs, TEXT("Map="), MapName);
+		FParse::Value(*InArgs, TEXT("Iterations="), Iterations);
+		FParse::Value(*InArgs, TEXT("Output="), OutputFile);
+		bQuit = Args.Contains(TEXT("Quit"));
+
+		ActorCounts = ParseList(InArgs, TEXT("Actors="), { 0, 100, 1000 });
+		WorldCounts = ParseList(InArgs, TEXT("Worlds="), { 1, 10, 50 });
+		ConnectionCounts = ParseList(InArgs, TEXT("Connections="), { 1, 10, 50 });
+		Iterations = FMath::Max(Iterations, 1);
+
+		FString ActorClassName;
+
+		if (FParse::Value(*InArgs, TEXT("ActorClass="), ActorClassName))
+		{
+			if (UClass* Class = LoadClass<AActor>(nullptr, *ActorClassName))
+			{
+				ActorClass = Class;
+			}
+		}
+
+		if (OutputFile.IsEmpty())
+		{
+			OutputFile = FPaths::ProfilingDir() / TEXT("RelatedWorld") / FString::Printf(TEXT("Benchmark-%s.csv"), *FDateTime::Now().ToString());
+		}
+	}
+
+	void Run()
+	{
+		UE_LOG(LogWorldDirector, Display, TEXT("RelatedWorld benchmark started"));
+
+		BenchmarkWorldLifetime();
+		BenchmarkTick();
+		BenchmarkMoveActorToWorld();
+		BenchmarkLookup();
+		BenchmarkConversion();
+		BenchmarkMovementSize();
+		BenchmarkReplication();
+
+		WriteResults();
+
+		if (bQuit)
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+	}
+
+private:
+	struct FResult
+	{
+		FString Case;
+		int32 Param;
+		int32 Iterations;
+		double TotalSeconds;
+	};
+
+	static TArray<int32> ParseList(const FString& Args, const TCHAR* Key, TArray<int32> Default)
+	{
+		FString Value;
+
+		if (!FParse::Value(*Args, Key, Value, false))
+		{
+			return Default;
+		}
+
+		TArray<FString> Items;
+		Value.ParseIntoArray(Items, TEXT(","));
+
+		TArray<int32> Result;
+
+		for (const FString& Item : Items)
+		{
+			Result.Add(FCString::Atoi(*Item));
+		}
+
+		return Result;
+	}
+
+	void AddResult(const FString& Case, int32 Param, int32 Count, double StartTime)
+	{
+		const double TotalSeconds = FPlatformTime::Seconds() - StartTime;
+		Results.Add({ Case, Param, Count, TotalSeconds });
+
+		UE_LOG(LogWorldDirector, Display, TEXT("%s(%d): %.3f us per iteration"), *Case, Param, TotalSeconds * 1000000.0 / FMath::Max(Count, 1));
+	}
+
+	/** Process memory growth is noisy, but it covers physics and FX scenes which the world estimate does not */
+	void LogMemoryGrowth(const FString& Case, int32 Count, uint64 StartUsedPhysical) const
+	{
+		const int64 Growth = (int64)FPlatformMemory::GetStats().UsedPhysical - (int64)StartUsedPhysical;
+		UE_LOG(LogWorldDirector, Display, TEXT("%s: %.1f KB used physical memory per world"), *Case, Growth / 1024.0 / FMath::Max(Count, 1));
+	}
+
+	FName MakeWorldName(int32 Index) const
+	{
+		return FName(*FString::Printf(TEXT("RWBenchmark_%d"), Index));
+	}
+
+	URelatedWorld* CreateWorld(int32 Index, int32 NumActors)
+	{
+		URelatedWorld* rWorld = Director->CreateEmptyWorld(World, MakeWorldName(Index), FIntVector(Index * 100000, 0, 0), EWorldDomain::WD_PRIVATE, World->GetNetDriver() != nullptr);
+
+		if (rWorld != nullptr)
+		{
+			SpawnActors(rWorld, NumActors);
+		}
+
+		return rWorld;
+	}
+
+	void SpawnActors(URelatedWorld* rWorld, int32 NumActors)
+	{
+		const int32 RowSize = FMath::Max(FMath::CeilToInt(FMath::Sqrt((float)NumActors)), 1);
+
+		for (int32 i = 0; i < NumActors; ++i)
+		{
+			const FVector Location((i % RowSize) * 200.f, (i / RowSize) * 200.f, 100.f);
+			rWorld->SpawnActor(ActorClass, FTransform(Location), ESpawnActorCollisionHandlingMethod::AlwaysSpawn, nullptr);
+		}
+	}
+
+	void GetWorldActors(URelatedWorld* rWorld, TArray<AActor*>& OutActors) const
+	{
+		for (AActor* Actor : rWorld->Context()->World()->PersistentLevel->Actors)
+		{
+			if (Actor != nullptr && Actor->IsA(ActorClass))
+			{
+				OutActors.Add(Actor);
+			}
+		}
+	}
+
+	void BenchmarkWorldLifetime()
+	{
+		const int32 Count = FMath::Min(Iterations, 50);
+		TArray<URelatedWorld*> CreatedWorlds;
+
+		uint64 StartUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+		double StartTime = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < Count; ++i)
+		{
+			if (URelatedWorld* rWorld = Director->CreateEmptyWorld(World, MakeWorldName(i), FIntVector::ZeroValue, EWorldDomain::WD_PRIVATE, false))
+			{
+				CreatedWorlds.Add(rWorld);
+			}
+		}
+
+		AddResult(TEXT("CreateEmptyWorld"), 0, Count, StartTime);
+		LogMemoryGrowth(TEXT("CreateEmptyWorld"), Count, StartUsedPhysical);
+		StartTime = FPlatformTime::Seconds();
+
+		for (URelatedWorld* rWorld : CreatedWorlds)
+		{
+			Director->UnloadRelatedWorld(rWorld);
+		}
+
+		AddResult(TEXT("UnloadRelatedWorld.Empty"), 0, Count, StartTime);
+
+		// Same worlds without AI, navigation, physics, FX and audio
+		FRelatedWorldCreateParams MinimalParams;
+		MinimalParams.bCreateAISystem = false;
+		MinimalParams.bCreateNavigation = false;
+		MinimalParams.bCreatePhysicsScene = false;
+		MinimalParams.bCreateFXSystem = false;
+		MinimalParams.bAllowAudioPlayback = false;
+		Director->SetWorldCreateProfile(MinimalProfile, MinimalParams);
+
+		CreatedWorlds.Reset();
+		StartUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+		StartTime = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < Count; ++i)
+		{
+			if (URelatedWorld* rWorld = Director->CreateEmptyWorld(World, MakeWorldName(i), FIntVector::ZeroValue, EWorldDomain::WD_PRIVATE, false, MinimalProfile))
+			{
+				CreatedWorlds.Add(rWorld);
+			}
+		}
+
+		AddResult(TEXT("CreateEmptyWorld.Minimal"), 0, Count, StartTime);
+		LogMemoryGrowth(TEXT("CreateEmptyWorld.Minimal"), Count, StartUsedPhysical);
+
+		for (URelatedWorld* rWorld : CreatedWorlds)
+		{
+			Director->UnloadRelatedWorld(rWorld);
+		}
+
+		if (MapName.IsEmpty())
+		{
+			return;
+		}
+
+		StartTime = FPlatformTime::Seconds();
+		URelatedWorld* rWorld = Director->LoadRelatedWorld(World, FName(*MapName), FIntVector::ZeroValue, EWorldDomain::WD_PRIVATE, false);
+		AddResult(TEXT("LoadRelatedWorld"), 0, 1, StartTime);
+
+		if (rWorld != nullptr)
+		{
+			StartTime = FPlatformTime::Seconds();
+			Director->UnloadRelatedWorld(rWorld);
+			AddResult(TEXT("UnloadRelatedWorld.Map"), 0, 1, StartTime);
+		}
+
+		StartTime = FPlatformTime::Seconds();
+		rWorld = Director->LoadRelatedWorld(World, FName(*MapName), FIntVector::ZeroValue, EWorldDomain::WD_PRIVATE, false, MinimalProfile);
+		AddResult(TEXT("LoadRelatedWorld.Minimal"), 0, 1, StartTime);
+
+		if (rWorld != nullptr)
+		{
+			Director->UnloadRelatedWorld(rWorld);
+		}
+
+		const FName TemplateName = FName(*MapName);
+
+		StartTime = FPlatformTime::Seconds();
+		const bool bTemplateLoaded = Director->LoadWorldTemplate(TemplateName);
+		AddResult(TEXT("LoadWorldTemplate"), 0, 1, StartTime);
+
+		if (!bTemplateLoaded)
+		{
+			return;
+		}
+
+		const int32 NumInstances = FMath::Min(Iterations, 10);
+		CreatedWorlds.Reset();
+		StartTime = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < NumInstances; ++i)
+		{
+			if (URelatedWorld* Instance = Director->CreateWorldInstance(World, TemplateName, MakeWorldName(i), FIntVector(i * 100000, 0, 0), EWorldDomain::WD_PRIVATE, false))
+			{
+				CreatedWorlds.Add(Instance);
+			}
+		}
+
+		AddResult(TEXT("CreateWorldInstance"), 0, NumInstances, StartTime);
+
+		for (URelatedWorld* Instance : CreatedWorlds)
+		{
+			Director->UnloadRelatedWorld(Instance);
+		}
+
+		Director->UnloadWorldTemplate(TemplateName);
+	}
+
+	void BenchmarkTick()
+	{
+		for (int32 NumActors : ActorCounts)
+		{
+			URelatedWorld* rWorld = CreateWorld(0, NumActors);
+
+			if (rWorld == nullptr)
+			{
+				continue;
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+
+			for (int32 i = 0; i < Iterations; ++i)
+			{
+				rWorld->Tick(1.f / 30.f);
+			}
+
+			AddResult(TEXT("Tick"), NumActors, Iterations, StartTime);
+			Director->UnloadRelatedWorld(rWorld);
+		}
+
+		// Frame time of the whole director tick
+		for (int32 NumWorlds : WorldCounts)
+		{
+			TArray<URelatedWorld*> CreatedWorlds;
+
+			for (int32 i = 0; i < NumWorlds; ++i)
+			{
+				if (URelatedWorld* rWorld = CreateWorld(i, 10))
+				{
+					CreatedWorlds.Add(rWorld);
+				}
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+
+			for (int32 i = 0; i < Iterations; ++i)
+			{
+				Director->Tick(1.f / 30.f);
+			}
+
+			AddResult(TEXT("TickWorlds"), NumWorlds, Iterations, StartTime);
+
+			for (URelatedWorld* rWorld : CreatedWorlds)
+			{
+				Director->UnloadRelatedWorld(rWorld);
+			}
+		}
+
+		BenchmarkTickProfiles();
+	}
+
+	/** Per world cost of the lean server tick profile against the full one at 100 worlds */
+	void BenchmarkTickProfiles()
+	{
+		const int32 NumWorlds = 100;
+		TArray<URelatedWorld*> CreatedWorlds;
+
+		for (int32 i = 0; i < NumWorlds; ++i)
+		{
+			if (URelatedWorld* rWorld = CreateWorld(i, 10))
+			{
+				CreatedWorlds.Add(rWorld);
+			}
+		}
+
+		double ProfileSeconds[2] = { 0.0, 0.0 };
+		const ERelatedWorldTickProfile Profiles[2] = { ERelatedWorldTickProfile::TPR_FULL, ERelatedWorldTickProfile::TPR_SERVER };
+
+		for (int32 ProfileIndex = 0; ProfileIndex < 2; ++ProfileIndex)
+		{
+			// One untimed pass, so the first profile does not pay for cold caches and rebuilt level lists
+			for (URelatedWorld* rWorld : CreatedWorlds)
+			{
+				rWorld->SetTickProfile(Profiles[ProfileIndex]);
+				rWorld->Tick(1.f / 30.f);
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+
+			for (int32 i = 0; i < Iterations; ++i)
+			{
+				for (URelatedWorld* rWorld : CreatedWorlds)
+				{
+					rWorld->Tick(1.f / 30.f);
+				}
+			}
+
+			ProfileSeconds[ProfileIndex] = FPlatformTime::Seconds() - StartTime;
+			AddResult(ProfileIndex == 0 ? TEXT("Tick.ProfileFull") : TEXT("Tick.ProfileServer"), CreatedWorlds.Num(), Iterations * CreatedWorlds.Num(), StartTime);
+		}
+
+		const int32 NumTicks = FMath::Max(Iterations * CreatedWorlds.Num(), 1);
+		const double FullMicroseconds = ProfileSeconds[0] * 1000000.0 / NumTicks;
+		const double ServerMicroseconds = ProfileSeconds[1] * 1000000.0 / NumTicks;
+		UE_LOG(LogWorldDirector, Display, TEXT("Per world tick at %d worlds: TPR_FULL %.3f us, TPR_SERVER %.3f us, saved %.3f us (%.1f%%)"),
+			CreatedWorlds.Num(), FullMicroseconds, ServerMicroseconds, FullMicroseconds - ServerMicroseconds,
+			FullMicroseconds > 0.0 ? (FullMicroseconds - ServerMicroseconds) * 100.0 / FullMicroseconds : 0.0);
+
+		for (URelatedWorld* rWorld : CreatedWorlds)
+		{
+			Director->UnloadRelatedWorld(rWorld);
+		}
+	}
+
+	void BenchmarkMoveActorToWorld()
+	{
+		for (int32 NumActors : ActorCounts)
+		{
+			URelatedWorld* From = CreateWorld(0, NumActors);
+			URelatedWorld* To = CreateWorld(1, 0);
+
+			if (From != nullptr && To != nullptr && NumActors > 0)
+			{
+				TArray<AActor*> Actors;
+				GetWorldActors(From, Actors);
+
+				const double StartTime = FPlatformTime::Seconds();
+
+				for (AActor* Actor : Actors)
+				{
+					Director->MoveActorToWorld(To, Actor, true);
+				}
+
+				AddResult(TEXT("MoveActorToWorld"), NumActors, Actors.Num(), StartTime);
+
+				const double BatchStartTime = FPlatformTime::Seconds();
+				Director->MoveActorsToWorld(From, Actors, true);
+				AddResult(TEXT("MoveActorsToWorld"), NumActors, Actors.Num(), BatchStartTime);
+			}
+
+			if (From != nullptr)
+			{
+				Director->UnloadRelatedWorld(From);
+			}
+
+			if (To != nullptr)
+			{
+				Director->UnloadRelatedWorld(To);
+			}
+		}
+	}
+
+	void BenchmarkLookup()
+	{
+		for (int32 NumWorlds : WorldCounts)
+		{
+			TArray<URelatedWorld*> CreatedWorlds;
+			TArray<AActor*> Actors;
+
+			for (int32 i = 0; i < NumWorlds; ++i)
+			{
+				if (URelatedWorld* rWorld = CreateWorld(i, 10))
+				{
+					CreatedWorlds.Add(rWorld);
+					GetWorldActors(rWorld, Actors);
+				}
+			}
+
+			if (Actors.Num() > 0)
+			{
+				const int32 Count = Iterations * 1000;
+				int32 Found = 0;
+
+				const double StartTime = FPlatformTime::Seconds();
+
+				for (int32 i = 0; i < Count; ++i)
+				{
+					Found += Director->GetRelatedWorldFromActor(Actors[i % Actors.Num()]) != nullptr ? 1 : 0;
+				}
+
+				AddResult(TEXT("GetRelatedWorldFromActor"), NumWorlds, Count, StartTime);
+				ensure(Found == Count);
+			}
+
+			if (CreatedWorlds.Num() > 0)
+			{
+				// Worlds are placed 100000 units apart along X by CreateWorld
+				const FBox WorldBounds(FVector(-50000.f, -50000.f, -10000.f), FVector(50000.f, 50000.f, 10000.f));
+
+				for (URelatedWorld* rWorld : CreatedWorlds)
+				{
+					rWorld->SetWorldBounds(WorldBounds);
+				}
+
+				const int32 Count = Iterations * 1000;
+				int32 Found = 0;
+
+				const double StartTime = FPlatformTime::Seconds();
+
+				for (int32 i = 0; i < Count; ++i)
+				{
+					const FVector Location((i % CreatedWorlds.Num()) * 100000.f + 100.f, 100.f, 0.f);
+					Found += Director->FindWorldsAtLocation(Location).Num();
+				}
+
+				AddResult(TEXT("FindWorldsAtLocation"), NumWorlds, Count, StartTime);
+				ensure(Found == Count);
+			}
+
+			for (URelatedWorld* rWorld : CreatedWorlds)
+			{
+				Director->UnloadRelatedWorld(rWorld);
+			}
+		}
+	}
+
+	void BenchmarkConversion()
+	{
+		const int32 Count = Iterations * 1000;
+		const FIntVector From(100000, -250000, 5000);
+		const FIntVector To(-300000, 120000, 0);
+
+		TArray<FVector> Locations;
+		Locations.SetNumUninitialized(Count);
+
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Locations[i] = FVector(FMath::FRandRange(-WORLD_MAX, WORLD_MAX), FMath::FRandRange(-WORLD_MAX, WORLD_MAX), FMath::FRandRange(-10000.f, 10000.f));
+		}
+
+		TArray<FVector> Converted;
+		Converted.SetNumUninitialized(Count);
+
+		double StartTime = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Converted[i] = URelatedWorldUtils::CONVERT_RelToWorld(From, Locations[i]);
+		}
+
+		AddResult(TEXT("CONVERT_RelToWorld"), 0, Count, StartTime);
+		StartTime = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Converted[i] = URelatedWorldUtils::CONVERT_WorldToRel(From, Locations[i]);
+		}
+
+		AddResult(TEXT("CONVERT_WorldToRel"), 0, Count, StartTime);
+		StartTime = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Converted[i] = URelatedWorldUtils::CONVERT_RelToRel(From, To, Locations[i]);
+		}
+
+		AddResult(TEXT("CONVERT_RelToRel"), 0, Count, StartTime);
+		StartTime = FPlatformTime::Seconds();
+
+		URelatedWorldUtils::CONVERT_RelToWorldBatch(Locations, From, Converted);
+
+		AddResult(TEXT("CONVERT_RelToWorldBatch"), 0, Count, StartTime);
+		StartTime = FPlatformTime::Seconds();
+
+		URelatedWorldUtils::CONVERT_WorldToRelBatch(Locations, From, Converted);
+
+		AddResult(TEXT("CONVERT_WorldToRelBatch"), 0, Count, StartTime);
+		StartTime = FPlatformTime::Seconds();
+
+		URelatedWorldUtils::CONVERT_RelToRelBatch(Locations, From, To, Converted);
+
+		AddResult(TEXT("CONVERT_RelToRelBatch"), 0, Count, StartTime);
+
+		TArray<FTransform> Transforms;
+		Transforms.Reserve(Count);
+
+		for (const FVector& Location : Locations)
+		{
+			Transforms.Add(FTransform(Location));
+		}
+
+		TArray<FTransform> ConvertedTransforms;
+		ConvertedTransforms.SetNum(Count);
+		StartTime = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < Count; ++i)
+		{
+			ConvertedTransforms[i] = Transforms[i];
+			ConvertedTransforms[i].SetLocation(URelatedWorldUtils::CONVERT_RelToWorld(From, Transforms[i].GetLocation()));
+		}
+
+		AddResult(TEXT("CONVERT_RelToWorld.Transform"), 0, Count, StartTime);
+		StartTime = FPlatformTime::Seconds();
+
+		URelatedWorldUtils::CONVERT_RelToWorldBatch(Transforms, From, ConvertedTransforms);
+
+		AddResult(TEXT("CONVERT_RelToWorldBatch.Transform"), 0, Count, StartTime);
+	}
+
+	void BenchmarkMovementSize()
+	{
+		const int32 Count = Iterations * 1000;
+
+		for (const int32 ExtentMeters : { 100, 1000, 10000 })
+		{
+			const float Extent = ExtentMeters * 100.f;
+			const FBox Bounds(FVector(-Extent, -Extent, -Extent * 0.1f), FVector(Extent, Extent, Extent * 0.1f));
+
+			TArray<FRepMovement> Movements;
+			Movements.SetNum(Count);
+
+			for (FRepMovement& Movement : Movements)
+			{
+				Movement.Location = FMath::RandPointInBox(Bounds);
+				Movement.Rotation = FRotator(0.f, FMath::FRandRange(-180.f, 180.f), 0.f);
+				Movement.LinearVelocity = FVector(FMath::FRandRange(-600.f, 600.f), FMath::FRandRange(-600.f, 600.f), 0.f);
+			}
+
+			bool bSuccess = true;
+			FBitWriter RepMovementWriter(0, true);
+			double StartTime = FPlatformTime::Seconds();
+
+			for (FRepMovement& Movement : Movements)
+			{
+				Movement.NetSerialize(RepMovementWriter, nullptr, bSuccess);
+			}
+
+			AddResult(TEXT("NetSerialize.RepMovement"), ExtentMeters, Count, StartTime);
+
+			FRelatedWorldRepMovement CompactMovement;
+			CompactMovement.SetLayoutBounds(&Bounds);
+			FBitWriter CompactWriter(0, true);
+			StartTime = FPlatformTime::Seconds();
+
+			for (const FRepMovement& Movement : Movements)
+			{
+				CompactMovement.SetMovement(Movement);
+				CompactMovement.NetSerialize(CompactWriter, nullptr, bSuccess);
+			}
+
+			AddResult(TEXT("NetSerialize.CompactMovement"), ExtentMeters, Count, StartTime);
+
+			UE_LOG(LogWorldDirector, Display, TEXT("Movement in %d m bounds: %.1f bits FRepMovement, %.1f bits compact"),
+				ExtentMeters, double(RepMovementWriter.GetNumBits()) / Count, double(CompactWriter.GetNumBits()) / Count);
+		}
+	}
+
+	/** Simulated connection drops outgoing packets, so it measures gathering and serialization without socket cost */
+	UNetConnection* AddSimulatedConnection(UNetDriver* NetDriver, AActor* ViewTarget)
+	{
+		USimulatedClientNetConnection* Connection = NewObject<USimulatedClientNetConnection>();
+		Connection->InitConnection(NetDriver, USOCK_Open, World->URL, 1000000);
+		Connection->InitSendBuffer();
+		Connection->OwningActor = ViewTarget;
+		Connection->ViewTarget = ViewTarget;
+		NetDriver->AddClientConnection(Connection);
+
+		return Connection;
+	}
+
+	void BenchmarkReplication()
+	{
+		UNetDriver* NetDriver = World->GetNetDriver();
+
+		if (NetDriver == nullptr || !NetDriver->IsServer())
+		{
+			UE_LOG(LogWorldDirector, Display, TEXT("No server net driver, replication benchmark skipped"));
+			return;
+		}
+
+		// Viewers of simulated connections stand in the middle of the worlds placed by CreateWorld
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		AActor* ViewTarget = World->SpawnActor<AActor>(ADefaultPawn::StaticClass(), FTransform(FVector(0.f, 0.f, 100.f)), SpawnParams);
+
+		for (int32 NumWorlds : WorldCounts)
+		{
+			TArray<URelatedWorld*> CreatedWorlds;
+
+			for (int32 i = 0; i < NumWorlds; ++i)
+			{
+				if (URelatedWorld* rWorld = CreateWorld(i, 10))
+				{
+					CreatedWorlds.Add(rWorld);
+				}
+			}
+
+			TArray<UNetConnection*> SimulatedConnections;
+
+			for (int32 NumConnections : ConnectionCounts)
+			{
+				while (NetDriver->ClientConnections.Num() < NumConnections)
+				{
+					SimulatedConnections.Add(AddSimulatedConnection(NetDriver, ViewTarget));
+				}
+
+				const double StartTime = FPlatformTime::Seconds();
+
+				for (int32 i = 0; i < Iterations; ++i)
+				{
+					NetDriver->ServerReplicateActors(1.f / 30.f);
+				}
+
+				AddResult(FString::Printf(TEXT("ServerReplicateActors.Connections%d"), NetDriver->ClientConnections.Num()), NumWorlds, Iterations, StartTime);
+			}
+
+			for (UNetConnection* Connection : SimulatedConnections)
+			{
+				Connection->CleanUp();
+			}
+
+			for (URelatedWorld* rWorld : CreatedWorlds)
+			{
+				Director->UnloadRelatedWorld(rWorld);
+			}
+		}
+
+		if (ViewTarget != nullptr)
+		{
+			ViewTarget->Destroy();
+		}
+	}
+
+	void WriteResults() const
+	{
+		FString Output = TEXT("Case,Param,Iterations,TotalMs,AverageUs\n");
+
+		for (const FResult& Result : Results)
+		{
+			Output += FString::Printf(TEXT("%s,%d,%d,%.4f,%.4f\n"),
+				*Result.Case,
+				Result.Param,
+				Result.Iterations,
+				Result.TotalSeconds * 1000.0,
+				Result.TotalSeconds * 1000000.0 / FMath::Max(Result.Iterations, 1));
+		}
+
+		if (FFileHelper::SaveStringToFile(Output, *OutputFile))
+		{
+			UE_LOG(LogWorldDirector, Display, TEXT("RelatedWorld benchmark results saved to %s"), *OutputFile);
+		}
+		else
+		{
+			UE_LOG(LogWorldDirector, Error, TEXT("Failed to save RelatedWorld benchmark results to %s"), *OutputFile);
+		}
+	}
+
+private:
+	UWorld* World;
+	UWorldDirector* Director;
+	FString MapName;
+	FString OutputFile;
+	int32 Iterations;
+	TArray<int32> ActorCounts;
+	TArray<int32> WorldCounts;
+	TArray<int32> ConnectionCounts;
+	UClass* ActorClass;
+	bool bQuit;
+	const FName MinimalProfile = TEXT("RWBenchmark_Minimal");
+	TArray<FResult> Results;
+};
+
+static FAutoConsoleCommandWithWorldAndArgs RelatedWorldBenchmarkCmd(
+	TEXT("RelatedWorld.Benchmark"),
+	TEXT("Run RelatedWorld micro benchmarks and write results into CSV file. Args: Map= Actors= Worlds= Connections= Iterations= ActorClass= Output= Quit"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr)
+		{
+			return;
+		}
+
+		FRelatedWorldBenchmark Benchmark(World, Args);
+		Benchmark.Run();
+	})
+);
+
+#endif
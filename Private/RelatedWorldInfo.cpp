@@ -0,0 +1,89 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#include "RelatedWorldInfo.h"
+
+#include "Net/UnrealNetwork.h"
+
+FOnRelatedWorldInfoChanged ARelatedWorldInfo::OnWorldInfoAdded;
+TMap<TTuple<const UWorld*, uint16>, ARelatedWorldInfo*> ARelatedWorldInfo::WorldInfos;
+
+ARelatedWorldInfo::ARelatedWorldInfo()
+{
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	bNetLoadOnClient = false;
+}
+
+void ARelatedWorldInfo::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(ARelatedWorldInfo, WorldId, COND_InitialOnly);
+	DOREPLIFETIME(ARelatedWorldInfo, WorldSector);
+	DOREPLIFETIME(ARelatedWorldInfo, WorldBounds);
+}
+
+ARelatedWorldInfo* ARelatedWorldInfo::FindWorldInfo(const UWorld* World, uint16 WorldId)
+{
+	return WorldInfos.FindRef(MakeTuple(World, WorldId));
+}
+
+void ARelatedWorldInfo::InitWorldInfo(URelatedWorld* InRelatedWorld, uint16 InWorldId, const FRelatedWorldSector& InWorldSector, const FBox& InWorldBounds)
+{
+	// Called before FinishSpawning, the info is sent with its initial state
+	RelatedWorld = InRelatedWorld;
+	WorldId = InWorldId;
+	WorldBounds = InWorldBounds;
+	WorldSector = InWorldSector;
+	WorldSector.ToTranslation(WorldTranslation);
+}
+
+void ARelatedWorldInfo::SetWorldSector(const FRelatedWorldSector& InWorldSector)
+{
+	WorldSector = InWorldSector;
+	OnRep_WorldSector();
+	ForceNetUpdate();
+}
+
+void ARelatedWorldInfo::SetWorldBounds(const FBox& InWorldBounds)
+{
+	WorldBounds = InWorldBounds;
+	OnRep_WorldBounds();
+	ForceNetUpdate();
+}
+
+void ARelatedWorldInfo::OnRep_WorldBounds()
+{
+	OnWorldBoundsChanged.Broadcast(this);
+}
+
+void ARelatedWorldInfo::OnRep_WorldSector()
+{
+	WorldSector.ToTranslation(WorldTranslation);
+
+	OnWorldTranslationChanged.Broadcast(this);
+}
+
+void ARelatedWorldInfo::BeginPlay()
+{
+	Super::BeginPlay();
+
+	WorldInfos.Add(MakeTuple((const UWorld*)GetWorld(), WorldId), this);
+
+	if (GetLocalRole() != ROLE_Authority)
+	{
+		OnWorldInfoAdded.Broadcast(this);
+	}
+}
+
+void ARelatedWorldInfo::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	const TTuple<const UWorld*, uint16> Key = MakeTuple((const UWorld*)GetWorld(), WorldId);
+
+	if (WorldInfos.FindRef(Key) == this)
+	{
+		WorldInfos.Remove(Key);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,184 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#include "WorldDirector.h"
+#include "RelatedWorld.h"
+
+#include "Engine/Level.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/UObjectHash.h"
+
+DECLARE_CYCLE_STAT(TEXT("Estimate World Memory"), STAT_RelatedWorld_EstimateWorldMemory, STATGROUP_RelatedWorld);
+DECLARE_MEMORY_STAT(TEXT("Related Worlds Memory"), STAT_RelatedWorld_WorldsMemory, STATGROUP_RelatedWorld);
+
+int64 UWorldDirector::EstimateWorldMemory(URelatedWorld* RelatedWorld) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_EstimateWorldMemory);
+
+	UWorld* World = RelatedWorld->Context()->World();
+
+	// Streaming levels live in their own packages, shared assets are outside of world packages
+	TArray<UPackage*, TInlineAllocator<4>> Packages;
+
+	for (ULevel* Level : World->GetLevels())
+	{
+		if (Level != nullptr)
+		{
+			Packages.AddUnique(Level->GetOutermost());
+		}
+	}
+
+	int64 Size = 0;
+	TArray<UObject*> Objects;
+
+	for (UPackage* Package : Packages)
+	{
+		Objects.Reset();
+		GetObjectsWithOuter(Package, Objects, true);
+
+		for (UObject* Object : Objects)
+		{
+			FArchiveCountMem CountMem(Object);
+			Size += Object->GetClass()->GetPropertiesSize();
+			Size += CountMem.GetMax();
+			Size += Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		}
+	}
+
+	return Size;
+}
+
+int64 UWorldDirector::GetWorldMemoryUsage(URelatedWorld* RelatedWorld, bool bForceUpdate)
+{
+	if (RelatedWorld == nullptr || RelatedWorld->Context() == nullptr)
+	{
+		return 0;
+	}
+
+	if (bForceUpdate || RelatedWorld->MemoryUsage == 0)
+	{
+		RelatedWorld->MemoryUsage = EstimateWorldMemory(RelatedWorld);
+	}
+
+	return RelatedWorld->MemoryUsage;
+}
+
+int64 UWorldDirector::GetWorldsMemoryUsage() const
+{
+	int64 Size = 0;
+
+	for (const TPair<FName, URelatedWorld*>& World : Worlds)
+	{
+		Size += World.Value->MemoryUsage;
+	}
+
+	return Size;
+}
+
+void UWorldDirector::UpdateMemoryBudget()
+{
+	if (TickingWorlds.Num() == 0)
+	{
+		return;
+	}
+
+	// Measuring is expensive, one world is measured per frame
+	MemoryUpdateIndex = (MemoryUpdateIndex + 1) % TickingWorlds.Num();
+	GetWorldMemoryUsage(TickingWorlds[MemoryUpdateIndex], true);
+
+	const int64 Usage = GetWorldsMemoryUsage();
+	SET_MEMORY_STAT(STAT_RelatedWorld_WorldsMemory, Usage);
+
+	if (Usage <= (int64)(WorldsMemoryBudget * 1024.f * 1024.f))
+	{
+		return;
+	}
+
+	URelatedWorld* Candidate = nullptr;
+
+	for (URelatedWorld* rWorld : TickingWorlds)
+	{
+		if (rWorld->GetWorldDomain() == EWorldDomain::WD_PUBLIC || rWorld->GetViewerCount() > 0 || rWorld->ReferenceCount > 0 || rWorld->EmptyTime <= 0.f)
+		{
+			continue;
+		}
+
+		if (Candidate == nullptr || rWorld->EmptyTime > Candidate->EmptyTime)
+		{
+			Candidate = rWorld;
+		}
+	}
+
+	if (Candidate == nullptr)
+	{
+		return;
+	}
+
+	const FName WorldName = Candidate->GetWorldName();
+	bool bSnapshot = false;
+
+	if (bSnapshotEvictedWorlds)
+	{
+		bSnapshot = SaveWorldSnapshot(Candidate, EvictedWorlds.FindOrAdd(WorldName));
+	}
+
+	UE_LOG(LogWorldDirector, Log, TEXT("Memory budget exceeded (%.1f MB), evicting world %s (%.1f MB)"), Usage / 1024.f / 1024.f, *WorldName.ToString(), Candidate->MemoryUsage / 1024.f / 1024.f);
+
+	// One world per frame, its estimate is gone from the sum right away
+	UnloadRelatedWorldAsync(Candidate);
+	OnRelatedWorldEvicted.Broadcast(WorldName, bSnapshot);
+}
+
+URelatedWorld* UWorldDirector::RestoreEvictedWorld(UObject* WorldContextObject, FName WorldName)
+{
+	const FRelatedWorldSnapshot* EvictedSnapshot = EvictedWorlds.Find(WorldName);
+
+	if (EvictedSnapshot == nullptr)
+	{
+		return nullptr;
+	}
+
+	// Copy, the map may change while the world is created
+	const FRelatedWorldSnapshot Snapshot = *EvictedSnapshot;
+
+	// Evicted world may still be unloading, it would block the restore
+	FlushPendingUnload(WorldName);
+
+	URelatedWorld* rWorld = RestoreWorldSnapshot(WorldContextObject, Snapshot);
+
+	// Snapshot is kept if the restore failed, so it can be tried again
+	if (rWorld != nullptr)
+	{
+		EvictedWorlds.Remove(WorldName);
+	}
+
+	return rWorld;
+}
+
+static void DumpRelatedWorldsMemory(FOutputDevice& Ar)
+{
+	UWorldDirector* Director = UWorldDirector::Get();
+	TArray<URelatedWorld*> RelatedWorlds = Director->GetRelatedWorlds();
+
+	int64 Total = 0;
+
+	for (URelatedWorld* rWorld : RelatedWorlds)
+	{
+		const int64 Size = Director->GetWorldMemoryUsage(rWorld, true);
+		Total += Size;
+
+		Ar.Logf(TEXT("%-32s %10.2f MB  Actors: %6d  Viewers: %3d  Hibernated: %d"),
+			*rWorld->GetWorldName().ToString(),
+			Size / 1024.f / 1024.f,
+			rWorld->Context()->World()->PersistentLevel->Actors.Num(),
+			rWorld->GetViewerCount(),
+			rWorld->IsHibernated() ? 1 : 0);
+	}
+
+	Ar.Logf(TEXT("%d related worlds, %.2f MB total, budget %.2f MB"), RelatedWorlds.Num(), Total / 1024.f / 1024.f, Director->WorldsMemoryBudget);
+}
+
+static FAutoConsoleCommandWithOutputDevice RelatedWorldMemoryCommand(
+	TEXT("RelatedWorld.Memory"),
+	TEXT("Prints estimated memory of every related world"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&DumpRelatedWorldsMemory));
@@ -0,0 +1,266 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#include "RelatedWorldRepMovement.h"
+
+#include "Engine/NetSerialization.h"
+
+/** Larger bounds fall back to packed vector, three axes fit into PackedLocation */
+static const uint32 MaxLocationAxisBits = 30;
+
+static double GetLocationScale(EVectorQuantization QuantizationLevel)
+{
+	switch (QuantizationLevel)
+	{
+		case EVectorQuantization::RoundTwoDecimals:
+			return 100.0;
+		case EVectorQuantization::RoundOneDecimal:
+			return 10.0;
+		default:
+			return 1.0;
+	}
+}
+
+/** Same packing FRepMovement uses for the level */
+static bool SerializeQuantizedVector(FArchive& Ar, FVector& Vector, EVectorQuantization QuantizationLevel)
+{
+	switch (QuantizationLevel)
+	{
+		case EVectorQuantization::RoundTwoDecimals:
+			return SerializePackedVector<100, 30>(Vector, Ar);
+		case EVectorQuantization::RoundOneDecimal:
+			return SerializePackedVector<10, 27>(Vector, Ar);
+		default:
+			return SerializePackedVector<1, 24>(Vector, Ar);
+	}
+}
+
+static void WriteBits(uint8* Buffer, int32& BitPos, uint32 Value, int32 NumBits)
+{
+	for (int32 i = 0; i < NumBits; ++i, ++BitPos)
+	{
+		if (Value & (1u << i))
+		{
+			Buffer[BitPos >> 3] |= 1 << (BitPos & 7);
+		}
+	}
+}
+
+static uint32 ReadBits(const uint8* Buffer, int32& BitPos, int32 NumBits)
+{
+	uint32 Value = 0;
+
+	for (int32 i = 0; i < NumBits; ++i, ++BitPos)
+	{
+		if (Buffer[BitPos >> 3] & (1 << (BitPos & 7)))
+		{
+			Value |= 1u << i;
+		}
+	}
+
+	return Value;
+}
+
+FRelatedWorldRepMovement::FRelatedWorldRepMovement()
+	: Location(ForceInitToZero)
+	, Rotation(ForceInitToZero)
+	, LinearVelocity(ForceInitToZero)
+	, AngularVelocity(ForceInitToZero)
+	, bSimulatedPhysicSleep(false)
+	, bRepPhysics(false)
+	, bLocationPacked(false)
+	, LayoutBounds(nullptr)
+	, LocationQuantizationLevel(EVectorQuantization::RoundWholeNumber)
+	, VelocityQuantizationLevel(EVectorQuantization::RoundWholeNumber)
+	, RotationQuantizationLevel(ERotatorQuantization::ByteComponents)
+{
+	FMemory::Memzero(PackedLocation);
+}
+
+void FRelatedWorldRepMovement::SetQuantization(const FRepMovement& Movement)
+{
+	LocationQuantizationLevel = Movement.LocationQuantizationLevel;
+	VelocityQuantizationLevel = Movement.VelocityQuantizationLevel;
+	RotationQuantizationLevel = Movement.RotationQuantizationLevel;
+}
+
+bool FRelatedWorldRepMovement::GetLocationLayout(int64 OutMin[3], uint8 OutBits[3]) const
+{
+	if (LayoutBounds == nullptr || !LayoutBounds->IsValid)
+	{
+		return false;
+	}
+
+	const FBox& Bounds = *LayoutBounds;
+
+	const double Scale = GetLocationScale(LocationQuantizationLevel);
+
+	for (int32 i = 0; i < 3; ++i)
+	{
+		OutMin[i] = (int64)FMath::FloorToDouble(Bounds.Min[i] * Scale);
+		const int64 Max = (int64)FMath::CeilToDouble(Bounds.Max[i] * Scale);
+		const uint64 Bits = FMath::Max<uint64>(FMath::CeilLogTwo64(uint64(Max - OutMin[i]) + 1), 1);
+
+		if (Bits > MaxLocationAxisBits)
+		{
+			return false;
+		}
+
+		OutBits[i] = (uint8)Bits;
+	}
+
+	return true;
+}
+
+void FRelatedWorldRepMovement::SetMovement(const FRepMovement& Movement)
+{
+	SetQuantization(Movement);
+
+	Location = Movement.Location;
+	Rotation = Movement.Rotation;
+	LinearVelocity = Movement.LinearVelocity;
+	AngularVelocity = Movement.AngularVelocity;
+	bSimulatedPhysicSleep = Movement.bSimulatedPhysicSleep;
+	bRepPhysics = Movement.bRepPhysics;
+
+	bLocationPacked = false;
+	FMemory::Memzero(PackedLocation);
+
+	int64 Min[3];
+	uint8 Bits[3];
+
+	if (!GetLocationLayout(Min, Bits))
+	{
+		return;
+	}
+
+	const double Scale = GetLocationScale(LocationQuantizationLevel);
+	uint32 Offsets[3];
+
+	// Same rounding as packed vector, so precision does not change
+	for (int32 i = 0; i < 3; ++i)
+	{
+		const int64 Offset = (int64)FMath::RoundToDouble(Location[i] * Scale) - Min[i];
+
+		if (Offset < 0 || Offset >= (int64(1) << Bits[i]))
+		{
+			return;
+		}
+
+		Offsets[i] = (uint32)Offset;
+	}
+
+	int32 BitPos = 0;
+
+	for (int32 i = 0; i < 3; ++i)
+	{
+		WriteBits(PackedLocation, BitPos, Offsets[i], Bits[i]);
+	}
+
+	bLocationPacked = true;
+}
+
+bool FRelatedWorldRepMovement::GetMovement(FRepMovement& Movement) const
+{
+	if (bLocationPacked)
+	{
+		int64 Min[3];
+		uint8 Bits[3];
+
+		if (!GetLocationLayout(Min, Bits))
+		{
+			return false;
+		}
+
+		const double Scale = GetLocationScale(LocationQuantizationLevel);
+		int32 BitPos = 0;
+
+		for (int32 i = 0; i < 3; ++i)
+		{
+			Movement.Location[i] = (float)((Min[i] + ReadBits(PackedLocation, BitPos, Bits[i])) / Scale);
+		}
+	}
+	else
+	{
+		Movement.Location = Location;
+	}
+
+	Movement.Rotation = Rotation;
+	Movement.LinearVelocity = LinearVelocity;
+	Movement.AngularVelocity = AngularVelocity;
+	Movement.bSimulatedPhysicSleep = bSimulatedPhysicSleep;
+	Movement.bRepPhysics = bRepPhysics;
+
+	return true;
+}
+
+bool FRelatedWorldRepMovement::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	uint8 Flags = (bSimulatedPhysicSleep << 0) | (bRepPhysics << 1) | (bLocationPacked << 2);
+	Ar.SerializeBits(&Flags, 3);
+	bSimulatedPhysicSleep = (Flags & (1 << 0)) ? 1 : 0;
+	bRepPhysics = (Flags & (1 << 1)) ? 1 : 0;
+	bLocationPacked = (Flags & (1 << 2)) ? 1 : 0;
+
+	bOutSuccess = true;
+
+	// Size of packed location comes from the layout bounds, the receiver got them before any movement
+	if (bLocationPacked)
+	{
+		int64 Min[3];
+		uint8 Bits[3];
+
+		if (!GetLocationLayout(Min, Bits))
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return true;
+		}
+
+		if (Ar.IsLoading())
+		{
+			FMemory::Memzero(PackedLocation);
+		}
+
+		Ar.SerializeBits(PackedLocation, Bits[0] + Bits[1] + Bits[2]);
+	}
+	else
+	{
+		bOutSuccess &= SerializeQuantizedVector(Ar, Location, LocationQuantizationLevel);
+	}
+
+	switch (RotationQuantizationLevel)
+	{
+		case ERotatorQuantization::ByteComponents:
+		{
+			Rotation.SerializeCompressed(Ar);
+			break;
+		}
+
+		case ERotatorQuantization::ShortComponents:
+		{
+			Rotation.SerializeCompressedShort(Ar);
+			break;
+		}
+	}
+
+	bOutSuccess &= SerializeQuantizedVector(Ar, LinearVelocity, VelocityQuantizationLevel);
+
+	if (bRepPhysics)
+	{
+		bOutSuccess &= SerializeQuantizedVector(Ar, AngularVelocity, VelocityQuantizationLevel);
+	}
+
+	return true;
+}
+
+bool FRelatedWorldRepMovement::operator==(const FRelatedWorldRepMovement& Other) const
+{
+	return Location == Other.Location
+		&& Rotation == Other.Rotation
+		&& LinearVelocity == Other.LinearVelocity
+		&& AngularVelocity == Other.AngularVelocity
+		&& bSimulatedPhysicSleep == Other.bSimulatedPhysicSleep
+		&& bRepPhysics == Other.bRepPhysics
+		&& bLocationPacked == Other.bLocationPacked
+		&& FMemory::Memcmp(PackedLocation, Other.PackedLocation, sizeof(PackedLocation)) == 0;
+}
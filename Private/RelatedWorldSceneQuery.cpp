@@ -0,0 +1,171 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#include "WorldDirector.h"
+#include "RelatedWorld.h"
+
+#include "Engine/World.h"
+#include "Components/PrimitiveComponent.h"
+#include "Async/ParallelFor.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+DECLARE_CYCLE_STAT(TEXT("Line Trace Batch"), STAT_RelatedWorld_LineTraceBatch, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("Overlap Sphere Batch"), STAT_RelatedWorld_OverlapSphereBatch, STATGROUP_RelatedWorld);
+
+void UWorldDirector::GatherQueryWorlds(const TArray<FBox>& QueryBounds, TArray<URelatedWorld*>& OutWorlds, TArray<TArray<int32>>& OutQueries) const
+{
+	TMap<URelatedWorld*, int32> WorldIndices;
+
+	for (int32 QueryIndex = 0; QueryIndex < QueryBounds.Num(); ++QueryIndex)
+	{
+		for (URelatedWorld* rWorld : FindWorldsInBox(QueryBounds[QueryIndex]))
+		{
+			if (rWorld->Context()->World()->GetPhysicsScene() == nullptr)
+			{
+				continue;
+			}
+
+			int32* WorldIndex = WorldIndices.Find(rWorld);
+
+			if (WorldIndex == nullptr)
+			{
+				WorldIndex = &WorldIndices.Add(rWorld, OutWorlds.Add(rWorld));
+				OutQueries.AddDefaulted();
+			}
+
+			OutQueries[*WorldIndex].Add(QueryIndex);
+		}
+	}
+}
+
+static void TranslateHitToWorld(const FIntVector& Translation, FHitResult& Hit)
+{
+	Hit.Location = FVector_NetQuantize(URelatedWorldUtils::CONVERT_RelToWorld(Translation, Hit.Location));
+	Hit.ImpactPoint = FVector_NetQuantize(URelatedWorldUtils::CONVERT_RelToWorld(Translation, Hit.ImpactPoint));
+	Hit.TraceStart = FVector_NetQuantize(URelatedWorldUtils::CONVERT_RelToWorld(Translation, Hit.TraceStart));
+	Hit.TraceEnd = FVector_NetQuantize(URelatedWorldUtils::CONVERT_RelToWorld(Translation, Hit.TraceEnd));
+}
+
+void UWorldDirector::LineTraceBatch(const TArray<FRelatedWorldLineTrace>& Traces, ETraceTypeQuery TraceChannel, TArray<FRelatedWorldTraceHit>& OutHits, bool bTraceComplex)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_LineTraceBatch);
+	RELATEDWORLD_TRACE_SCOPE(RelatedWorld_LineTraceBatch);
+
+	OutHits.Reset(Traces.Num());
+	OutHits.AddDefaulted(Traces.Num());
+
+	TArray<FBox> QueryBounds;
+	QueryBounds.Reserve(Traces.Num());
+
+	for (const FRelatedWorldLineTrace& Trace : Traces)
+	{
+		QueryBounds.Add(FBox(Trace.Start.ComponentMin(Trace.End), Trace.Start.ComponentMax(Trace.End)));
+	}
+
+	TArray<URelatedWorld*> QueryWorlds;
+	TArray<TArray<int32>> WorldQueries;
+	GatherQueryWorlds(QueryBounds, QueryWorlds, WorldQueries);
+
+	const ECollisionChannel Channel = UEngineTypes::ConvertToCollisionChannel(TraceChannel);
+	const FCollisionQueryParams Params(FName(TEXT("RelatedWorldTrace")), bTraceComplex);
+
+	// Every world writes only its own hits, the closest one is picked after the parallel part
+	TArray<TArray<FHitResult>> WorldHits;
+	WorldHits.SetNum(QueryWorlds.Num());
+
+	ParallelFor(QueryWorlds.Num(), [&](int32 WorldIndex)
+	{
+		UWorld* World = QueryWorlds[WorldIndex]->Context()->World();
+		const FIntVector Translation = QueryWorlds[WorldIndex]->GetWorldTranslation();
+		const TArray<int32>& Queries = WorldQueries[WorldIndex];
+		TArray<FHitResult>& Hits = WorldHits[WorldIndex];
+
+		Hits.SetNum(Queries.Num());
+
+		for (int32 i = 0; i < Queries.Num(); ++i)
+		{
+			const FRelatedWorldLineTrace& Trace = Traces[Queries[i]];
+			const FVector Start = URelatedWorldUtils::CONVERT_WorldToRel(Translation, Trace.Start);
+			const FVector End = URelatedWorldUtils::CONVERT_WorldToRel(Translation, Trace.End);
+
+			if (World->LineTraceSingleByChannel(Hits[i], Start, End, Channel, Params))
+			{
+				TranslateHitToWorld(Translation, Hits[i]);
+			}
+		}
+	}, QueryWorlds.Num() < 2);
+
+	for (int32 WorldIndex = 0; WorldIndex < QueryWorlds.Num(); ++WorldIndex)
+	{
+		const TArray<int32>& Queries = WorldQueries[WorldIndex];
+
+		for (int32 i = 0; i < Queries.Num(); ++i)
+		{
+			const FHitResult& Hit = WorldHits[WorldIndex][i];
+			FRelatedWorldTraceHit& Result = OutHits[Queries[i]];
+
+			// Translation does not change the fraction along the line, so hits of different worlds are comparable
+			if (Hit.bBlockingHit && (Result.World == nullptr || Hit.Time < Result.Hit.Time))
+			{
+				Result.World = QueryWorlds[WorldIndex];
+				Result.Hit = Hit;
+			}
+		}
+	}
+}
+
+void UWorldDirector::OverlapSphereBatch(const TArray<FVector>& Centers, float Radius, ETraceTypeQuery TraceChannel, TArray<FRelatedWorldOverlap>& OutOverlaps)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_OverlapSphereBatch);
+	RELATEDWORLD_TRACE_SCOPE(RelatedWorld_OverlapSphereBatch);
+
+	OutOverlaps.Reset();
+
+	TArray<FBox> QueryBounds;
+	QueryBounds.Reserve(Centers.Num());
+
+	for (const FVector& Center : Centers)
+	{
+		QueryBounds.Add(FBox::BuildAABB(Center, FVector(Radius)));
+	}
+
+	TArray<URelatedWorld*> QueryWorlds;
+	TArray<TArray<int32>> WorldQueries;
+	GatherQueryWorlds(QueryBounds, QueryWorlds, WorldQueries);
+
+	const ECollisionChannel Channel = UEngineTypes::ConvertToCollisionChannel(TraceChannel);
+	const FCollisionQueryParams Params(FName(TEXT("RelatedWorldOverlap")), false);
+	const FCollisionShape Shape = FCollisionShape::MakeSphere(Radius);
+
+	TArray<TArray<FRelatedWorldOverlap>> WorldOverlaps;
+	WorldOverlaps.SetNum(QueryWorlds.Num());
+
+	ParallelFor(QueryWorlds.Num(), [&](int32 WorldIndex)
+	{
+		URelatedWorld* rWorld = QueryWorlds[WorldIndex];
+		UWorld* World = rWorld->Context()->World();
+		const FIntVector Translation = rWorld->GetWorldTranslation();
+		TArray<FOverlapResult> Overlaps;
+
+		for (int32 QueryIndex : WorldQueries[WorldIndex])
+		{
+			const FVector Center = URelatedWorldUtils::CONVERT_WorldToRel(Translation, Centers[QueryIndex]);
+
+			Overlaps.Reset();
+			World->OverlapMultiByChannel(Overlaps, Center, FQuat::Identity, Channel, Shape, Params);
+
+			for (const FOverlapResult& Overlap : Overlaps)
+			{
+				FRelatedWorldOverlap& Result = WorldOverlaps[WorldIndex].AddDefaulted_GetRef();
+				Result.QueryIndex = QueryIndex;
+				Result.World = rWorld;
+				Result.Actor = Overlap.GetActor();
+				Result.Component = Overlap.GetComponent();
+			}
+		}
+	}, QueryWorlds.Num() < 2);
+
+	for (TArray<FRelatedWorldOverlap>& Overlaps : WorldOverlaps)
+	{
+		OutOverlaps.Append(MoveTemp(Overlaps));
+	}
+}
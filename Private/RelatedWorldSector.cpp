@@ -0,0 +1,135 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#include "RelatedWorldSector.h"
+
+#include "Engine/NetSerialization.h"
+
+static void NormalizeAxis(int64& Sector, float& Offset)
+{
+	const float Whole = FMath::FloorToFloat(Offset / FRelatedWorldSector::SectorSize);
+
+	if (Whole != 0.f)
+	{
+		Sector += (int64)Whole;
+		Offset -= Whole * FRelatedWorldSector::SectorSize;
+	}
+}
+
+static void SplitAxis(int64 Value, int64& OutSector, float& OutOffset)
+{
+	OutSector = Value >> FRelatedWorldSector::SectorShift;
+	OutOffset = (float)(Value - (OutSector << FRelatedWorldSector::SectorShift));
+}
+
+/** Sector is clamped before it is scaled, so the join can not overflow int64 */
+static int64 JoinAxis(int64 Sector, float Offset)
+{
+	const int64 MaxSector = int64(1) << (62 - FRelatedWorldSector::SectorShift);
+
+	return FMath::Clamp(Sector, -MaxSector, MaxSector) * (int64(1) << FRelatedWorldSector::SectorShift) + FMath::RoundToInt(Offset);
+}
+
+static bool JoinAxis(int64 Sector, float Offset, int32& OutValue)
+{
+	const int64 Value = JoinAxis(Sector, Offset);
+	OutValue = (int32)FMath::Clamp<int64>(Value, MIN_int32, MAX_int32);
+
+	return Value >= MIN_int32 && Value <= MAX_int32;
+}
+
+static float SubtractAxis(int64 SectorA, float OffsetA, int64 SectorB, float OffsetB)
+{
+	return (float)((double)(SectorA - SectorB) * FRelatedWorldSector::SectorSize + ((double)OffsetA - (double)OffsetB));
+}
+
+/** Zig-zag encoded sector split into two packed ints, sectors near zero take one byte */
+static void SerializeSector(FArchive& Ar, int64& Sector)
+{
+	uint64 Encoded = (uint64(Sector) << 1) ^ uint64(Sector >> 63);
+	uint32 Low = uint32(Encoded);
+	uint32 High = uint32(Encoded >> 32);
+
+	Ar.SerializeIntPacked(Low);
+	Ar.SerializeIntPacked(High);
+
+	if (Ar.IsLoading())
+	{
+		Encoded = (uint64(High) << 32) | Low;
+		Sector = int64(Encoded >> 1) ^ -int64(Encoded & 1);
+	}
+}
+
+FRelatedWorldSector::FRelatedWorldSector(int64 InSectorX, int64 InSectorY, int64 InSectorZ, const FVector& InOffset)
+	: SectorX(InSectorX)
+	, SectorY(InSectorY)
+	, SectorZ(InSectorZ)
+	, Offset(InOffset)
+{
+	Normalize();
+}
+
+FRelatedWorldSector FRelatedWorldSector::FromTranslation(const FIntVector& Translation)
+{
+	FRelatedWorldSector Result;
+	SplitAxis(Translation.X, Result.SectorX, Result.Offset.X);
+	SplitAxis(Translation.Y, Result.SectorY, Result.Offset.Y);
+	SplitAxis(Translation.Z, Result.SectorZ, Result.Offset.Z);
+
+	return Result;
+}
+
+bool FRelatedWorldSector::ToTranslation(FIntVector& OutTranslation) const
+{
+	const bool bFitsX = JoinAxis(SectorX, Offset.X, OutTranslation.X);
+	const bool bFitsY = JoinAxis(SectorY, Offset.Y, OutTranslation.Y);
+	const bool bFitsZ = JoinAxis(SectorZ, Offset.Z, OutTranslation.Z);
+
+	return bFitsX && bFitsY && bFitsZ;
+}
+
+FIntVector FRelatedWorldSector::ToClampedTranslation() const
+{
+	FIntVector Result;
+	ToTranslation(Result);
+
+	return Result;
+}
+
+void FRelatedWorldSector::Normalize()
+{
+	NormalizeAxis(SectorX, Offset.X);
+	NormalizeAxis(SectorY, Offset.Y);
+	NormalizeAxis(SectorZ, Offset.Z);
+}
+
+FRelatedWorldSector FRelatedWorldSector::operator+(const FVector& Delta) const
+{
+	return FRelatedWorldSector(SectorX, SectorY, SectorZ, Offset + Delta);
+}
+
+FVector FRelatedWorldSector::operator-(const FRelatedWorldSector& Other) const
+{
+	return FVector
+	(
+		SubtractAxis(SectorX, Offset.X, Other.SectorX, Other.Offset.X),
+		SubtractAxis(SectorY, Offset.Y, Other.SectorY, Other.Offset.Y),
+		SubtractAxis(SectorZ, Offset.Z, Other.SectorZ, Other.Offset.Z)
+	);
+}
+
+bool FRelatedWorldSector::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	SerializeSector(Ar, SectorX);
+	SerializeSector(Ar, SectorY);
+	SerializeSector(Ar, SectorZ);
+
+	// Normalized offset is below 2^20, two decimals need 27 bits per component
+	bOutSuccess = SerializePackedVector<100, 30>(Offset, Ar);
+
+	return true;
+}
+
+FString FRelatedWorldSector::ToString() const
+{
+	return FString::Printf(TEXT("Sector=(%lld,%lld,%lld) Offset=(%s)"), SectorX, SectorY, SectorZ, *Offset.ToString());
+}
@@ -0,0 +1,310 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#include "RelatedWorldSnapshot.h"
+#include "WorldDirector.h"
+#include "RelatedWorld.h"
+
+#include "GameFramework/Pawn.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/PlayerState.h"
+#include "GameFramework/WorldSettings.h"
+#include "GameFramework/GameNetworkManager.h"
+#include "NavigationData.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+DECLARE_CYCLE_STAT(TEXT("Save World Snapshot"), STAT_RelatedWorld_SaveWorldSnapshot, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("Restore World Snapshot"), STAT_RelatedWorld_RestoreWorldSnapshot, STATGROUP_RelatedWorld);
+
+namespace RelatedWorldSnapshot
+{
+	const int32 Version = 1;
+
+	enum EActorFlags : uint8
+	{
+		/** Actor is loaded with the map and found by name, otherwise it is spawned by class */
+		AF_MapActor = 1 << 0,
+		AF_Scaled = 1 << 1
+	};
+
+	static void SerializeSaveGame(AActor* Actor, FArchive& InnerArchive)
+	{
+		FObjectAndNameAsStringProxyArchive Ar(InnerArchive, true);
+		Ar.ArIsSaveGame = true;
+		Actor->Serialize(Ar);
+	}
+}
+
+bool UWorldDirector::ShouldSnapshotActor(URelatedWorld* RelatedWorld, AActor* Actor) const
+{
+	if (!IsValid(Actor) || Actor->IsA<AWorldSettings>() || Actor->IsA<APlayerState>() || Actor->IsA<AGameNetworkManager>())
+	{
+		return false;
+	}
+
+	// Player controllers belong to connections and AI controllers are spawned again by their pawns, navigation is rebuilt by the world
+	if (Actor->IsA<AController>() || Actor->IsA<ANavigationData>())
+	{
+		return false;
+	}
+
+	APawn* Pawn = Cast<APawn>(Actor);
+
+	if (Pawn != nullptr && Pawn->IsPlayerControlled())
+	{
+		return false;
+	}
+
+	// Actors created together with empty world exist in the restored world anyway
+	const TArray<TWeakObjectPtr<AActor>>* InitialActors = EmptyWorldActors.Find(RelatedWorld->Context()->World());
+
+	return InitialActors == nullptr || !InitialActors->Contains(Actor);
+}
+
+bool UWorldDirector::SaveWorldSnapshot(URelatedWorld* RelatedWorld, FRelatedWorldSnapshot& OutSnapshot)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_SaveWorldSnapshot);
+	RELATEDWORLD_TRACE_SCOPE(RelatedWorld_SaveWorldSnapshot);
+
+	if (RelatedWorld == nullptr || RelatedWorld->Context() == nullptr)
+	{
+		return false;
+	}
+
+	UWorld* World = RelatedWorld->Context()->World();
+	const bool bHasMap = !RelatedWorld->GetMapName().IsNone();
+
+	OutSnapshot.WorldName = RelatedWorld->GetWorldName();
+	OutSnapshot.MapName = RelatedWorld->GetMapName();
+	OutSnapshot.CreateProfile = RelatedWorld->GetCreateProfile();
+	OutSnapshot.WorldDomain = RelatedWorld->GetWorldDomain();
+	OutSnapshot.WorldTranslation = RelatedWorld->GetWorldTranslation();
+	OutSnapshot.WorldSector = RelatedWorld->GetWorldSector();
+	OutSnapshot.bNetworked = RelatedWorld->IsNetworkedWorld();
+	OutSnapshot.Data.Reset();
+
+	TArray<AActor*> Actors;
+	TArray<UClass*> Classes;
+	TArray<FString> ClassPaths;
+
+	for (AActor* Actor : World->PersistentLevel->Actors)
+	{
+		if (ShouldSnapshotActor(RelatedWorld, Actor))
+		{
+			Actors.Add(Actor);
+
+			if (!(bHasMap && Actor->HasAnyFlags(RF_WasLoaded)) && !Classes.Contains(Actor->GetClass()))
+			{
+				Classes.Add(Actor->GetClass());
+				ClassPaths.Add(Actor->GetClass()->GetPathName());
+			}
+		}
+	}
+
+	FMemoryWriter Writer(OutSnapshot.Data, true);
+	int32 Version = RelatedWorldSnapshot::Version;
+	int32 NumActors = Actors.Num();
+
+	Writer << Version;
+	Writer << ClassPaths;
+	Writer << NumActors;
+
+	TArray<uint8> ActorData;
+
+	for (AActor* Actor : Actors)
+	{
+		const bool bMapActor = bHasMap && Actor->HasAnyFlags(RF_WasLoaded);
+		const FTransform Transform = Actor->GetActorTransform();
+
+		// Location is stored relative to the world translation, origin shift of the world is removed
+		FVector Location = FRepMovement::RebaseOntoZeroOrigin(Transform.GetLocation(), World->OriginLocation);
+		FRotator Rotation = Transform.Rotator();
+		FVector Scale = Transform.GetScale3D();
+
+		uint8 Flags = 0;
+		Flags |= bMapActor ? RelatedWorldSnapshot::AF_MapActor : 0;
+		Flags |= !Scale.Equals(FVector::OneVector) ? RelatedWorldSnapshot::AF_Scaled : 0;
+		Writer << Flags;
+
+		if (bMapActor)
+		{
+			FName ActorName = Actor->GetFName();
+			Writer << ActorName;
+		}
+		else
+		{
+			int32 ClassIndex = Classes.IndexOfByKey(Actor->GetClass());
+			Writer << ClassIndex;
+		}
+
+		Writer << Location;
+		Rotation.SerializeCompressedShort(Writer);
+
+		if (Flags & RelatedWorldSnapshot::AF_Scaled)
+		{
+			Writer << Scale;
+		}
+
+		ActorData.Reset();
+		FMemoryWriter ActorWriter(ActorData, true);
+		RelatedWorldSnapshot::SerializeSaveGame(Actor, ActorWriter);
+		Writer << ActorData;
+	}
+
+	return true;
+}
+
+URelatedWorld* UWorldDirector::RestoreWorldSnapshot(UObject* WorldContextObject, const FRelatedWorldSnapshot& Snapshot)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_RestoreWorldSnapshot);
+	RELATEDWORLD_TRACE_SCOPE(RelatedWorld_RestoreWorldSnapshot);
+
+	if (!Snapshot.IsValid())
+	{
+		return nullptr;
+	}
+
+	URelatedWorld* rWorld = nullptr;
+	TGuardValue<const FRelatedWorldSnapshot*> RestoringGuard(RestoringSnapshot, &Snapshot);
+
+	if (Snapshot.MapName.IsNone())
+	{
+		rWorld = CreateEmptyWorld(WorldContextObject, Snapshot.WorldName, Snapshot.WorldTranslation, Snapshot.WorldDomain, Snapshot.bNetworked, Snapshot.CreateProfile);
+	}
+	else if (Snapshot.MapName == Snapshot.WorldName)
+	{
+		rWorld = LoadRelatedWorld(WorldContextObject, Snapshot.WorldName, Snapshot.WorldTranslation, Snapshot.WorldDomain, Snapshot.bNetworked, Snapshot.CreateProfile);
+	}
+	else
+	{
+		rWorld = CreateWorldInstance(WorldContextObject, Snapshot.MapName, Snapshot.WorldName, Snapshot.WorldTranslation, Snapshot.WorldDomain, Snapshot.bNetworked, Snapshot.CreateProfile);
+	}
+
+	// Actors are applied by RegisterRelatedWorld, locations are stored relative to the world so the sector can change after
+	if (rWorld != nullptr && rWorld->GetWorldSector() != Snapshot.WorldSector)
+	{
+		rWorld->TranslateWorldSector(Snapshot.WorldSector);
+	}
+
+	return rWorld;
+}
+
+void UWorldDirector::ApplyWorldSnapshot(URelatedWorld* RelatedWorld, const FRelatedWorldSnapshot& Snapshot)
+{
+	UWorld* World = RelatedWorld->Context()->World();
+	FMemoryReader Reader(Snapshot.Data, true);
+
+	int32 Version = 0;
+	Reader << Version;
+
+	if (Version != RelatedWorldSnapshot::Version)
+	{
+		UE_LOG(LogWorldDirector, Warning, TEXT("Snapshot of world %s has unsupported version %d"), *Snapshot.WorldName.ToString(), Version);
+		return;
+	}
+
+	TArray<FString> ClassPaths;
+	Reader << ClassPaths;
+
+	TArray<UClass*> Classes;
+
+	for (const FString& ClassPath : ClassPaths)
+	{
+		UClass* Class = LoadClass<AActor>(nullptr, *ClassPath);
+
+		if (Class == nullptr)
+		{
+			UE_LOG(LogWorldDirector, Warning, TEXT("Snapshot of world %s references missing class %s"), *Snapshot.WorldName.ToString(), *ClassPath);
+		}
+
+		Classes.Add(Class);
+	}
+
+	// Map actors missing in the snapshot were destroyed before it was made
+	TMap<FName, AActor*> MapActors;
+
+	if (!Snapshot.MapName.IsNone())
+	{
+		for (AActor* Actor : World->PersistentLevel->Actors)
+		{
+			if (ShouldSnapshotActor(RelatedWorld, Actor) && Actor->HasAnyFlags(RF_WasLoaded))
+			{
+				MapActors.Add(Actor->GetFName(), Actor);
+			}
+		}
+	}
+
+	int32 NumActors = 0;
+	Reader << NumActors;
+
+	TArray<uint8> ActorData;
+
+	for (int32 i = 0; i < NumActors && !Reader.IsError(); ++i)
+	{
+		uint8 Flags = 0;
+		FName ActorName;
+		int32 ClassIndex = INDEX_NONE;
+		FVector Location;
+		FRotator Rotation;
+		FVector Scale = FVector::OneVector;
+
+		Reader << Flags;
+
+		if (Flags & RelatedWorldSnapshot::AF_MapActor)
+		{
+			Reader << ActorName;
+		}
+		else
+		{
+			Reader << ClassIndex;
+		}
+
+		Reader << Location;
+		Rotation.SerializeCompressedShort(Reader);
+
+		if (Flags & RelatedWorldSnapshot::AF_Scaled)
+		{
+			Reader << Scale;
+		}
+
+		Reader << ActorData;
+
+		const FTransform Transform(Rotation, FRepMovement::RebaseOntoLocalOrigin(Location, World->OriginLocation), Scale);
+		FMemoryReader ActorReader(ActorData, true);
+
+		if (Flags & RelatedWorldSnapshot::AF_MapActor)
+		{
+			AActor* Actor = nullptr;
+
+			if (MapActors.RemoveAndCopyValue(ActorName, Actor))
+			{
+				Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::TeleportPhysics);
+				RelatedWorldSnapshot::SerializeSaveGame(Actor, ActorReader);
+			}
+
+			continue;
+		}
+
+		UClass* Class = Classes.IsValidIndex(ClassIndex) ? Classes[ClassIndex] : nullptr;
+
+		if (Class == nullptr)
+		{
+			continue;
+		}
+
+		// World has not begun play yet, so SaveGame properties override construction script before BeginPlay
+		AActor* Actor = RelatedWorld->SpawnActor(Class, Transform, ESpawnActorCollisionHandlingMethod::AlwaysSpawn, nullptr);
+
+		if (Actor != nullptr)
+		{
+			RelatedWorldSnapshot::SerializeSaveGame(Actor, ActorReader);
+		}
+	}
+
+	for (TPair<FName, AActor*>& MapActor : MapActors)
+	{
+		World->DestroyActor(MapActor.Value);
+	}
+}
@@ -0,0 +1,208 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#include "WorldDirector.h"
+#include "RelatedWorld.h"
+
+DECLARE_CYCLE_STAT(TEXT("Find Worlds"), STAT_RelatedWorld_FindWorlds, STATGROUP_RelatedWorld);
+
+/** Worlds covering more cells are kept in a list instead of the grid */
+static const int64 MaxSpatialCellsPerWorld = 4096;
+
+static int32 ToSpatialCell(float Value, float CellSize)
+{
+	return FMath::Clamp(FMath::FloorToInt(Value / CellSize), -MAX_int32 + 1, MAX_int32 - 1);
+}
+
+bool UWorldDirector::GetSpatialCellRange(const FBox& Box, FIntVector& OutMin, FIntVector& OutMax) const
+{
+	const float CellSize = FMath::Max(SpatialIndexCellSize, 1.f);
+
+	OutMin = FIntVector(ToSpatialCell(Box.Min.X, CellSize), ToSpatialCell(Box.Min.Y, CellSize), ToSpatialCell(Box.Min.Z, CellSize));
+	OutMax = FIntVector(ToSpatialCell(Box.Max.X, CellSize), ToSpatialCell(Box.Max.Y, CellSize), ToSpatialCell(Box.Max.Z, CellSize));
+
+	const int64 NumCells = int64(OutMax.X - OutMin.X + 1) * int64(OutMax.Y - OutMin.Y + 1) * int64(OutMax.Z - OutMin.Z + 1);
+
+	return NumCells <= MaxSpatialCellsPerWorld;
+}
+
+void UWorldDirector::AddToSpatialIndex(URelatedWorld* RelatedWorld)
+{
+	const FBox Bounds = RelatedWorld->GetWorldBounds();
+
+	// Clamped translation would stack far worlds at the edge of the range, float queries can not reach them anyway
+	if (!Bounds.IsValid || RelatedWorld->IsTranslationClamped())
+	{
+		return;
+	}
+
+	SpatialBounds.Add(RelatedWorld, Bounds);
+
+	FIntVector Min, Max;
+
+	if (!GetSpatialCellRange(Bounds, Min, Max))
+	{
+		LargeSpatialWorlds.Add(RelatedWorld);
+		return;
+	}
+
+	for (int32 X = Min.X; X <= Max.X; ++X)
+	{
+		for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+		{
+			for (int32 Z = Min.Z; Z <= Max.Z; ++Z)
+			{
+				SpatialCells.FindOrAdd(FIntVector(X, Y, Z)).Add(RelatedWorld);
+			}
+		}
+	}
+}
+
+void UWorldDirector::RemoveFromSpatialIndex(URelatedWorld* RelatedWorld)
+{
+	FBox Bounds;
+
+	if (!SpatialBounds.RemoveAndCopyValue(RelatedWorld, Bounds))
+	{
+		return;
+	}
+
+	FIntVector Min, Max;
+
+	if (!GetSpatialCellRange(Bounds, Min, Max))
+	{
+		LargeSpatialWorlds.RemoveSwap(RelatedWorld);
+		return;
+	}
+
+	for (int32 X = Min.X; X <= Max.X; ++X)
+	{
+		for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+		{
+			for (int32 Z = Min.Z; Z <= Max.Z; ++Z)
+			{
+				const FIntVector Cell(X, Y, Z);
+				TArray<URelatedWorld*, TInlineAllocator<2>>* CellWorlds = SpatialCells.Find(Cell);
+
+				if (CellWorlds != nullptr)
+				{
+					CellWorlds->RemoveSwap(RelatedWorld);
+
+					if (CellWorlds->Num() == 0)
+					{
+						SpatialCells.Remove(Cell);
+					}
+				}
+			}
+		}
+	}
+}
+
+void UWorldDirector::UpdateSpatialIndex(URelatedWorld* RelatedWorld)
+{
+	// Worlds which are being created are indexed by RegisterRelatedWorld
+	if (Worlds.FindRef(RelatedWorld->GetWorldName()) != RelatedWorld)
+	{
+		return;
+	}
+
+	RemoveFromSpatialIndex(RelatedWorld);
+	AddToSpatialIndex(RelatedWorld);
+}
+
+TArray<URelatedWorld*> UWorldDirector::FindWorldsAtLocation(const FVector& Location) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_FindWorlds);
+
+	TArray<URelatedWorld*> Result;
+	const float CellSize = FMath::Max(SpatialIndexCellSize, 1.f);
+	const FIntVector Cell(ToSpatialCell(Location.X, CellSize), ToSpatialCell(Location.Y, CellSize), ToSpatialCell(Location.Z, CellSize));
+
+	if (const TArray<URelatedWorld*, TInlineAllocator<2>>* CellWorlds = SpatialCells.Find(Cell))
+	{
+		for (URelatedWorld* rWorld : *CellWorlds)
+		{
+			if (SpatialBounds.FindChecked(rWorld).IsInsideOrOn(Location))
+			{
+				Result.Add(rWorld);
+			}
+		}
+	}
+
+	for (URelatedWorld* rWorld : LargeSpatialWorlds)
+	{
+		if (SpatialBounds.FindChecked(rWorld).IsInsideOrOn(Location))
+		{
+			Result.Add(rWorld);
+		}
+	}
+
+	return Result;
+}
+
+TArray<URelatedWorld*> UWorldDirector::FindWorldsInBox(const FBox& Box) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_FindWorlds);
+
+	TArray<URelatedWorld*> Result;
+
+	if (!Box.IsValid)
+	{
+		return Result;
+	}
+
+	FIntVector Min, Max;
+
+	if (GetSpatialCellRange(Box, Min, Max))
+	{
+		// World overlapping several cells is found in each of them
+		TSet<URelatedWorld*, DefaultKeyFuncs<URelatedWorld*>, TInlineSetAllocator<16>> Visited;
+
+		for (int32 X = Min.X; X <= Max.X; ++X)
+		{
+			for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+			{
+				for (int32 Z = Min.Z; Z <= Max.Z; ++Z)
+				{
+					const TArray<URelatedWorld*, TInlineAllocator<2>>* CellWorlds = SpatialCells.Find(FIntVector(X, Y, Z));
+
+					if (CellWorlds == nullptr)
+					{
+						continue;
+					}
+
+					for (URelatedWorld* rWorld : *CellWorlds)
+					{
+						bool bAlreadyVisited = false;
+						Visited.Add(rWorld, &bAlreadyVisited);
+
+						if (!bAlreadyVisited && SpatialBounds.FindChecked(rWorld).Intersect(Box))
+						{
+							Result.Add(rWorld);
+						}
+					}
+				}
+			}
+		}
+
+		for (URelatedWorld* rWorld : LargeSpatialWorlds)
+		{
+			if (SpatialBounds.FindChecked(rWorld).Intersect(Box))
+			{
+				Result.Add(rWorld);
+			}
+		}
+	}
+	else
+	{
+		// Box is larger than the grid is meant for, test bounds of every world
+		for (const TPair<const URelatedWorld*, FBox>& Pair : SpatialBounds)
+		{
+			if (Pair.Value.Intersect(Box))
+			{
+				Result.Add(const_cast<URelatedWorld*>(Pair.Key));
+			}
+		}
+	}
+
+	return Result;
+}
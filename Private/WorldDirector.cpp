@@ -3,36 +3,138 @@
 #include "WorldDirector.h"
 #include "RelatedWorld.h"
 #include "Components/RelatedLocationComponent.h"
+#include "Navigation/RelatedNavigationSystem.h"
+#include "RelatedWorldInfo.h"
+#include "Net/RwReplicationGraphBase.h"
 
 #include "EngineUtils.h"
 #include "ShaderCompiler.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine/LevelStreaming.h"
+#include "Engine/LevelBounds.h"
+#include "Misc/PackageName.h"
 #include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "NavigationData.h"
+#include "AI/AISystemBase.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
 DEFINE_LOG_CATEGORY(LogWorldDirector);
+CSV_DEFINE_CATEGORY_MODULE(RELATEDWORLD_API, RelatedWorld, true);
+#if ENGINE_MINOR_VERSION >= 26
+UE_TRACE_CHANNEL_DEFINE(RelatedWorldChannel);
+#endif
+
+DECLARE_CYCLE_STAT(TEXT("Tick Related Worlds"), STAT_RelatedWorld_TickWorlds, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("Create Empty World"), STAT_RelatedWorld_CreateEmptyWorld, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("Load Related World"), STAT_RelatedWorld_LoadRelatedWorld, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("Load World Template"), STAT_RelatedWorld_LoadWorldTemplate, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("Create World Instance"), STAT_RelatedWorld_CreateWorldInstance, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("Process Pending Loads"), STAT_RelatedWorld_ProcessPendingLoads, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("Process Pending Unloads"), STAT_RelatedWorld_ProcessPendingUnloads, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("Unload Related World"), STAT_RelatedWorld_UnloadRelatedWorld, STATGROUP_RelatedWorld);
+DECLARE_CYCLE_STAT(TEXT("Move Actor To World"), STAT_RelatedWorld_MoveActorToWorld, STATGROUP_RelatedWorld);
+
+UWorldDirector* UWorldDirector::Instance = nullptr;
+
+static UWorld::InitializationValues MakeInitializationValues(const FRelatedWorldCreateParams& CreateParams)
+{
+	return UWorld::InitializationValues()
+		.CreateAISystem(CreateParams.bCreateAISystem)
+		.CreateNavigation(CreateParams.bCreateNavigation)
+		.CreatePhysicsScene(CreateParams.bCreatePhysicsScene)
+		.CreateFXSystem(CreateParams.bCreateFXSystem)
+		.AllowAudioPlayback(CreateParams.bAllowAudioPlayback);
+}
+
+void UWorldDirector::BeginDestroy()
+{
+	if (Instance == this)
+	{
+		Instance = nullptr;
+	}
+
+	Super::BeginDestroy();
+}
 
-URelatedWorld* UWorldDirector::CreateEmptyWorld(UObject* WorldContextObject, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld)
+URelatedWorld* UWorldDirector::CreateEmptyWorld(UObject* WorldContextObject, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld, FName CreateProfile)
 {
-	URelatedWorld* rWorld = nullptr;
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_CreateEmptyWorld);
+	CSV_SCOPED_TIMING_STAT(RelatedWorld, CreateEmptyWorld);
+	RELATEDWORLD_TRACE_SCOPE(RelatedWorld_CreateEmptyWorld);
 
-	if (Worlds.Num())
+	if (!CanLoadWorld(WorldName))
 	{
-		rWorld = Worlds.FindRef(WorldName);
+		return nullptr;
+	}
 
-		if (rWorld != nullptr)
-		{
-			UE_LOG(LogWorldDirector, Warning, TEXT("World %s already loaded as %s"), *WorldName.ToString(), *rWorld->GetName());
-			return nullptr;
-		}
+	UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
+
+	// Pooled worlds have all subsystems
+	FWorldContext* PooledContext = CreateProfile.IsNone() ? AcquirePooledWorld(GameInstance) : nullptr;
+	FWorldContext& Context = PooledContext != nullptr ? *PooledContext : CreateEmptyWorldContext(GameInstance, WorldName, GetCreateParams(CreateProfile));
+
+	if (PooledContext != nullptr)
+	{
+		ReinitializePooledWorld(*PooledContext);
+	}
+	Context.World()->URL.Map = WorldName.ToString();
+
+	if (IsNetWorld)
+	{
+		Context.ActiveNetDrivers = GEngine->GetWorldContextFromWorld(WorldContextObject->GetWorld())->ActiveNetDrivers;
+		Context.World()->NetDriver = WorldContextObject->GetWorld()->NetDriver;
+	}
+	else
+	{
+		Context.ActiveNetDrivers.Empty();
+		Context.World()->NetDriver = nullptr;
+	}
+
+	URelatedWorld* rWorld = RegisterRelatedWorld(Context, WorldName, WorldTranslation, WorldDomain, IsNetWorld);
+	rWorld->SetCreateProfile(CreateProfile);
+
+	return rWorld;
+}
+
+FRelatedWorldCreateParams UWorldDirector::GetCreateParams(FName CreateProfile) const
+{
+	if (CreateProfile.IsNone())
+	{
+		return FRelatedWorldCreateParams();
+	}
+
+	const FRelatedWorldCreateParams* CreateParams = WorldCreateProfiles.Find(CreateProfile);
+
+	if (CreateParams == nullptr)
+	{
+		UE_LOG(LogWorldDirector, Warning, TEXT("World create profile %s is not found, all subsystems are created"), *CreateProfile.ToString());
+		return FRelatedWorldCreateParams();
 	}
 
+	return *CreateParams;
+}
+
+void UWorldDirector::SetWorldCreateProfile(FName ProfileName, const FRelatedWorldCreateParams& CreateParams)
+{
+	WorldCreateProfiles.Add(ProfileName, CreateParams);
+}
+
+FWorldContext& UWorldDirector::CreateEmptyWorldContext(UGameInstance* GameInstance, FName WorldName, const FRelatedWorldCreateParams& CreateParams)
+{
 	UWorld* World = nullptr;
 	FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
 	Context.PIEInstance = GPlayInEditorID;
-	Context.OwningGameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
+	Context.OwningGameInstance = GameInstance;
 
+#if ENGINE_MINOR_VERSION >= 26
+	const UWorld::InitializationValues IVS = MakeInitializationValues(CreateParams);
+	World = UWorld::CreateWorld(EWorldType::Game, true, WorldName, nullptr, true, ERHIFeatureLevel::Num, &IVS);
+#else
+	// CreateWorld always initializes physics and FX here, only subsystems created later are skipped
 	World = UWorld::CreateWorld(EWorldType::Game, true, WorldName);
+	World->bAllowAudioPlayback = CreateParams.bAllowAudioPlayback;
+#endif
 	World->SetGameInstance(Context.OwningGameInstance);
 	Context.SetCurrentWorld(World);
 	Context.World()->URL.Map = WorldName.ToString();
@@ -42,234 +144,1199 @@ URelatedWorld* UWorldDirector::CreateEmptyWorld(UObject* WorldContextObject, FNa
 		Context.World()->InitWorld();
 	}
 
-	if (IsNetWorld)
-	{
-		Context.ActiveNetDrivers = GEngine->GetWorldContextFromWorld(WorldContextObject->GetWorld())->ActiveNetDrivers;
-		Context.World()->NetDriver = WorldContextObject->GetWorld()->NetDriver;
-	}
-	else
+	Context.ActiveNetDrivers.Empty();
+	Context.World()->NetDriver = nullptr;
+
+	if (CreateParams.bCreateAISystem)
 	{
-		Context.ActiveNetDrivers.Empty();
-		Context.World()->NetDriver = nullptr;
+		Context.World()->CreateAISystem();
 	}
 
-	Context.World()->CreateAISystem();
 	Context.World()->InitializeActorsForPlay(Context.World()->URL, true);
-	FNavigationSystem::AddNavigationSystemToWorld(*Context.World(), FNavigationSystemRunMode::GameMode);
+
+	if (CreateParams.bCreateNavigation)
+	{
+		FNavigationSystem::AddNavigationSystemToWorld(*Context.World(), FNavigationSystemRunMode::GameMode);
+	}
 
 	Context.World()->bWorldWasLoadedThisTick = true;
 	Context.World()->SetShouldTick(false);
 
-	rWorld = NewObject<URelatedWorld>(this);
-	rWorld->AddToRoot();
-	rWorld->SetContext(&Context);
-	rWorld->SetDomain(WorldDomain);
-	rWorld->SetNetworked(IsNetWorld);
-	rWorld->TranslateWorld(WorldTranslation);
-	rWorld->SetPersistentWorld(Context.OwningGameInstance->GetWorld());
-	rWorld->HandleBeginPlay();
+	// Actors created with the world survive recycling, everything else is destroyed
+	TArray<TWeakObjectPtr<AActor>>& InitialActors = EmptyWorldActors.Add(World);
 
-	Worlds.Add(WorldName, rWorld);
+	for (FActorIterator ActorIt(World); ActorIt; ++ActorIt)
+	{
+		InitialActors.Add(*ActorIt);
+	}
 
-	return rWorld;
+	return Context;
 }
 
-URelatedWorld* UWorldDirector::LoadRelatedWorld(UObject* WorldContextObject, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld)
+void UWorldDirector::WarmUpWorldPool(UObject* WorldContextObject)
 {
-	URelatedWorld* rWorld = nullptr;
-	
-	if (Worlds.Num())
+	PoolGameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
+}
+
+void UWorldDirector::EmptyWorldPool()
+{
+	TArray<FWorldContext*> PooledContexts = MoveTemp(WorldPool);
+
+	for (FWorldContext* Context : PooledContexts)
 	{
-		rWorld = Worlds.FindRef(WorldName);
+		DestroyWorld(Context);
+	}
+}
 
-		if (rWorld != nullptr)
+FWorldContext* UWorldDirector::AcquirePooledWorld(UGameInstance* GameInstance)
+{
+	for (int32 i = WorldPool.Num() - 1; i >= 0; --i)
+	{
+		FWorldContext* Context = WorldPool[i];
+
+		if (Context->OwningGameInstance == GameInstance)
 		{
-			UE_LOG(LogWorldDirector, Warning, TEXT("World %s already loaded as %s"), *WorldName.ToString(), *rWorld->GetName());
-			return nullptr;
+			WorldPool.RemoveAtSwap(i, 1, false);
+			return Context;
 		}
 	}
 
-	UPackage* WorldPackage = nullptr;
-	UWorld* World = nullptr;
-	FString MapName = WorldName.ToString();
-	FURL URL(*MapName);
-	FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
-	Context.PIEInstance = GPlayInEditorID;
-	Context.OwningGameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
-	Context.OwningGameInstance->PreloadContentForURL(URL);
+	return nullptr;
+}
 
-	if (GPlayInEditorID > -1)
+void UWorldDirector::ReinitializePooledWorld(FWorldContext& Context)
+{
+	UWorld* World = Context.World();
+
+	// Physics and render state of initial actors are created again by registering their components
+	World->UpdateWorldComponents(false, false);
+
+	for (ULevel* Level : World->GetLevels())
 	{
-		const FString PIEPackageName = UWorld::ConvertToPIEPackageName(MapName, GPlayInEditorID);
-		const FName PIEPackageFName = FName(*PIEPackageName);
-		UWorld::WorldTypePreLoadMap.FindOrAdd(PIEPackageFName) = Context.WorldType;
-		FSoftObjectPath::AddPIEPackageName(PIEPackageFName);
-		UPackage* NewPackage = CreatePackage(nullptr, *PIEPackageName);
-		NewPackage->SetPackageFlags(PKG_PlayInEditor);
-		WorldPackage = LoadPackage(NewPackage, *MapName, LOAD_PackageForPIE);
-		UWorld::WorldTypePreLoadMap.Remove(PIEPackageFName);
+		Level->RouteActorInitialize();
+	}
 
-		if (WorldPackage == nullptr)
-		{
-			return nullptr;
-		}
+	if (UAISystemBase* AISystem = World->GetAISystem())
+	{
+		AISystem->InitializeActorsForPlay(true);
+	}
 
-		World = UWorld::FindWorldInPackage(WorldPackage);
-		WorldPackage->PIEInstanceID = GPlayInEditorID;
-		WorldPackage->SetPackageFlags(PKG_PlayInEditor);
+	FNavigationSystem::AddNavigationSystemToWorld(*World, FNavigationSystemRunMode::GameMode);
 
-		for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+	World->bWorldWasLoadedThisTick = true;
+}
+
+bool UWorldDirector::RecycleWorld(FWorldContext* Context)
+{
+	UWorld* World = Context->World();
+	const TArray<TWeakObjectPtr<AActor>>* InitialActors = EmptyWorldActors.Find(World);
+
+	if (InitialActors == nullptr || WorldPool.Num() >= EmptyWorldPoolSize)
+	{
+		return false;
+	}
+
+	TArray<AActor*> Actors;
+
+	for (FActorIterator ActorIt(World); ActorIt; ++ActorIt)
+	{
+		Actors.Add(*ActorIt);
+	}
+
+	// Destroyed replicated actors are removed from clients by the shared net driver
+	for (AActor* Actor : Actors)
+	{
+		if (InitialActors->Contains(Actor))
 		{
-			StreamingLevel->RenameForPIE(GPlayInEditorID);
+			// Components are registered and initialized again when the world is taken from the pool
+			Actor->RouteEndPlay(EEndPlayReason::RemovedFromWorld);
+			Actor->UnregisterAllComponents();
+		}
+		else
+		{
+			World->DestroyActor(Actor);
 		}
 	}
 
-	if (World == nullptr)
+	// Navigation system is created anew on reuse, so nav data and octree of the previous world are dropped
+	if (UNavigationSystemBase* NavSys = World->GetNavigationSystem())
 	{
-		UWorld::WorldTypePreLoadMap.FindOrAdd(WorldName) = Context.WorldType;
+		NavSys->CleanUp(FNavigationSystem::ECleanupMode::CleanupUnsafe);
+		World->SetNavigationSystem(nullptr);
+	}
 
-		WorldPackage = FindPackage(nullptr, *MapName);
+	if (UAISystemBase* AISystem = World->GetAISystem())
+	{
+		AISystem->CleanupWorld(true, true);
+	}
 
-		if (WorldPackage == nullptr)
-		{
-			WorldPackage = LoadPackage(nullptr, *MapName, LOAD_None);
-		}
+	World->bBegunPlay = false;
+	World->bMatchStarted = false;
+	World->TimeSeconds = 0.f;
+	World->UnpausedTimeSeconds = 0.f;
+	World->RealTimeSeconds = 0.f;
+	World->AudioTimeSeconds = 0.f;
+	World->DeltaTimeSeconds = 0.f;
 
-		UWorld::WorldTypePreLoadMap.Remove(WorldName);
+	Context->ActiveNetDrivers.Empty();
+	World->NetDriver = nullptr;
 
-		if (WorldPackage == nullptr)
-		{
-			return nullptr;
-		}
+	WorldPool.Add(Context);
 
-		World = UWorld::FindWorldInPackage(WorldPackage);
+	return true;
+}
 
-		if (World == nullptr)
-		{
-			return nullptr;
-		}
+void UWorldDirector::UpdateWorldPool()
+{
+	UGameInstance* GameInstance = PoolGameInstance.Get();
 
-		World->PersistentLevel->HandleLegacyMapBuildData();
+	if (GameInstance == nullptr)
+	{
+		return;
 	}
 
-	World->SetGameInstance(Context.OwningGameInstance);
-	Context.SetCurrentWorld(World);
-	Context.World()->WorldType = Context.WorldType;
+	for (int32 i = 0; i < EmptyWorldPoolWarmUpRate && WorldPool.Num() < EmptyWorldPoolSize; ++i)
+	{
+		const FName PoolWorldName = MakeUniqueObjectName(nullptr, UWorld::StaticClass(), TEXT("RelatedWorldPool"));
+		WorldPool.Add(&CreateEmptyWorldContext(GameInstance, PoolWorldName, FRelatedWorldCreateParams()));
+	}
+}
 
-	if (GPlayInEditorID > -1)
+bool UWorldDirector::NeedsWorldPoolWarmUp() const
+{
+	return EmptyWorldPoolWarmUpRate > 0 && WorldPool.Num() < EmptyWorldPoolSize && PoolGameInstance.IsValid();
+}
+
+URelatedWorld* UWorldDirector::LoadRelatedWorld(UObject* WorldContextObject, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld, FName CreateProfile)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_LoadRelatedWorld);
+	CSV_SCOPED_TIMING_STAT(RelatedWorld, LoadRelatedWorld);
+	RELATEDWORLD_TRACE_SCOPE(RelatedWorld_LoadRelatedWorld);
+
+	if (!CanLoadWorld(WorldName))
 	{
-		check(Context.World()->GetOutermost()->HasAnyPackageFlags(PKG_PlayInEditor));
-		Context.World()->ClearFlags(RF_Standalone);
+		return nullptr;
+	}
+
+	FString MapName = WorldName.ToString();
+	UGameplayStatics::GetGameInstance(WorldContextObject)->PreloadContentForURL(FURL(*MapName));
+
+	FPendingWorldLoad Load;
+	Load.WorldName = WorldName;
+	Load.MapName = WorldName;
+	Load.WorldTranslation = WorldTranslation;
+	Load.WorldDomain = WorldDomain;
+	Load.bNetWorld = IsNetWorld;
+	Load.PIEInstance = GPlayInEditorID;
+	Load.WorldContextObject = WorldContextObject;
+	Load.CreateProfile = CreateProfile;
+	Load.CreateParams = GetCreateParams(CreateProfile);
+	Load.World = LoadWorldPackage(MapName);
+
+	if (Load.World == nullptr)
+	{
+		return nullptr;
+	}
+
+	while (Load.Step != ERelatedWorldLoadStep::LS_READY && AdvanceWorldLoad(Load, false));
+
+	return Load.RelatedWorld;
+}
+
+bool UWorldDirector::LoadRelatedWorldAsync(UObject* WorldContextObject, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld, FOnRelatedWorldLoaded OnLoaded, FName CreateProfile)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_LoadRelatedWorld);
+	RELATEDWORLD_TRACE_SCOPE(RelatedWorld_LoadRelatedWorldAsync);
+
+	if (WorldContextObject == nullptr || !CanLoadWorld(WorldName))
+	{
+		return false;
+	}
+
+	FString MapName = WorldName.ToString();
+	UGameplayStatics::GetGameInstance(WorldContextObject)->PreloadContentForURL(FURL(*MapName));
+
+	// Gameplay code run by a load step may start another load, PendingLoads must not be reallocated under it
+	FPendingWorldLoad& Load = (bProcessingLoads ? QueuedLoads : PendingLoads).AddDefaulted_GetRef();
+	Load.WorldName = WorldName;
+	Load.MapName = WorldName;
+	Load.WorldTranslation = WorldTranslation;
+	Load.WorldDomain = WorldDomain;
+	Load.bNetWorld = IsNetWorld;
+	Load.PIEInstance = GPlayInEditorID;
+	Load.WorldContextObject = WorldContextObject;
+	Load.CreateProfile = CreateProfile;
+	Load.CreateParams = GetCreateParams(CreateProfile);
+	Load.OnLoaded = OnLoaded;
+
+	FLoadPackageAsyncDelegate OnPackageLoaded = FLoadPackageAsyncDelegate::CreateUObject(this, &UWorldDirector::OnWorldPackageLoaded, WorldName);
+
+	if (Load.PIEInstance > -1)
+	{
+		const FString PIEPackageName = UWorld::ConvertToPIEPackageName(MapName, Load.PIEInstance);
+		Load.PackageName = FName(*PIEPackageName);
+		UWorld::WorldTypePreLoadMap.FindOrAdd(Load.PackageName) = EWorldType::Game;
+		FSoftObjectPath::AddPIEPackageName(Load.PackageName);
+		LoadPackageAsync(PIEPackageName, nullptr, *MapName, OnPackageLoaded, PKG_PlayInEditor, Load.PIEInstance);
 	}
 	else
 	{
-		Context.World()->AddToRoot();
+		Load.PackageName = WorldName;
+		UWorld::WorldTypePreLoadMap.FindOrAdd(Load.PackageName) = EWorldType::Game;
+		LoadPackageAsync(MapName, nullptr, nullptr, OnPackageLoaded);
+	}
+
+	return true;
+}
+
+bool UWorldDirector::LoadWorldTemplate(FName MapName)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_LoadWorldTemplate);
+	CSV_SCOPED_TIMING_STAT(RelatedWorld, LoadWorldTemplate);
+	RELATEDWORLD_TRACE_SCOPE(RelatedWorld_LoadWorldTemplate);
+
+	if (WorldTemplates.Contains(MapName))
+	{
+		return true;
+	}
+
+	// Template is loaded into its own package, so the map can still be loaded by LoadRelatedWorld
+	const FString MapPackageName = MapName.ToString();
+	FString TemplatePackageName = FString::Printf(TEXT("/Temp/RelatedWorldTemplate/%s"), *FPackageName::GetShortName(MapPackageName));
+	uint32 LoadFlags = LOAD_None;
+
+	if (GPlayInEditorID > -1)
+	{
+		TemplatePackageName = UWorld::ConvertToPIEPackageName(TemplatePackageName, GPlayInEditorID);
+		LoadFlags = LOAD_PackageForPIE;
+	}
+
+	const FName TemplatePackageFName = FName(*TemplatePackageName);
+	UPackage* TemplatePackage = CreatePackage(nullptr, *TemplatePackageName);
+
+	if (GPlayInEditorID > -1)
+	{
+		TemplatePackage->SetPackageFlags(PKG_PlayInEditor);
+		TemplatePackage->PIEInstanceID = GPlayInEditorID;
+		FSoftObjectPath::AddPIEPackageName(TemplatePackageFName);
+	}
+
+	UWorld::WorldTypePreLoadMap.FindOrAdd(TemplatePackageFName) = EWorldType::Inactive;
+	TemplatePackage = LoadPackage(TemplatePackage, *MapPackageName, LoadFlags);
+	UWorld::WorldTypePreLoadMap.Remove(TemplatePackageFName);
+
+	UWorld* Template = TemplatePackage != nullptr ? UWorld::FindWorldInPackage(TemplatePackage) : nullptr;
+
+	if (Template == nullptr)
+	{
+		UE_LOG(LogWorldDirector, Warning, TEXT("Failed to load world template %s"), *MapPackageName);
+		return false;
+	}
+
+	Template->PersistentLevel->HandleLegacyMapBuildData();
+
+	if (Template->GetStreamingLevels().Num() > 0)
+	{
+		UE_LOG(LogWorldDirector, Warning, TEXT("World template %s has streaming levels, they are not instanced"), *MapPackageName);
+	}
+
+	Template->AddToRoot();
+	WorldTemplates.Add(MapName, Template);
+
+	return true;
+}
+
+void UWorldDirector::UnloadWorldTemplate(FName MapName)
+{
+	UWorld* Template = nullptr;
+
+	if (!WorldTemplates.RemoveAndCopyValue(MapName, Template))
+	{
+		return;
+	}
+
+	Template->RemoveFromRoot();
+	Template->ClearFlags(RF_Standalone);
+
+	// Instances may still use navigation data of the template, it is collected once nothing references it
+	if (!bShareTemplateNavigation)
+	{
+		Template->MarkObjectsPendingKill();
+	}
+}
+
+bool UWorldDirector::IsWorldTemplateLoaded(FName MapName) const
+{
+	return WorldTemplates.Contains(MapName);
+}
+
+URelatedWorld* UWorldDirector::CreateWorldInstance(UObject* WorldContextObject, FName TemplateName, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld, FName CreateProfile)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_CreateWorldInstance);
+	CSV_SCOPED_TIMING_STAT(RelatedWorld, CreateWorldInstance);
+	RELATEDWORLD_TRACE_SCOPE(RelatedWorld_CreateWorldInstance);
+
+	if (!CanLoadWorld(WorldName) || !LoadWorldTemplate(TemplateName))
+	{
+		return nullptr;
+	}
+
+	FPendingWorldLoad Load;
+	Load.WorldName = WorldName;
+	Load.MapName = TemplateName;
+	Load.WorldTranslation = WorldTranslation;
+	Load.WorldDomain = WorldDomain;
+	Load.bNetWorld = IsNetWorld;
+	Load.PIEInstance = GPlayInEditorID;
+	Load.WorldContextObject = WorldContextObject;
+	Load.CreateProfile = CreateProfile;
+	Load.CreateParams = GetCreateParams(CreateProfile);
+	Load.World = DuplicateWorldTemplate(WorldTemplates.FindChecked(TemplateName), WorldName);
+
+	if (bShareTemplateNavigation && Load.CreateParams.bCreateNavigation)
+	{
+		Load.SharedNavData = URelatedNavigationSystem::FindSharableNavData(*WorldTemplates.FindChecked(TemplateName));
+	}
+
+	if (Load.SharedNavData != nullptr)
+	{
+		// Instance copy of the shared navigation data is never initialized, drop it before the world is. Duplicated actors keep their names
+		for (int32 i = Load.World->PersistentLevel->Actors.Num() - 1; i >= 0; --i)
+		{
+			AActor* Actor = Load.World->PersistentLevel->Actors[i];
+
+			if (Actor != nullptr && Actor->GetFName() == Load.SharedNavData->GetFName())
+			{
+				Load.World->PersistentLevel->Actors.RemoveAt(i);
+				Actor->MarkPendingKill();
+				break;
+			}
+		}
+	}
+
+	while (Load.Step != ERelatedWorldLoadStep::LS_READY && AdvanceWorldLoad(Load, false));
+
+	return Load.RelatedWorld;
+}
+
+UWorld* UWorldDirector::DuplicateWorldTemplate(UWorld* Template, FName WorldName)
+{
+	FString PackageName = FString::Printf(TEXT("/Temp/RelatedWorld/%s"), *FPackageName::GetShortName(WorldName.ToString()));
+
+	if (GPlayInEditorID > -1)
+	{
+		PackageName = UWorld::ConvertToPIEPackageName(PackageName, GPlayInEditorID);
+	}
+
+	// Previous instance with the same name may still wait for garbage collection
+	const FName PackageFName = MakeUniqueObjectName(nullptr, UPackage::StaticClass(), FName(*PackageName));
+	UPackage* InstancePackage = CreatePackage(nullptr, *PackageFName.ToString());
+	InstancePackage->SetPackageFlags(PKG_ContainsMap);
+
+	if (GPlayInEditorID > -1)
+	{
+		InstancePackage->SetPackageFlags(PKG_PlayInEditor);
+		InstancePackage->PIEInstanceID = GPlayInEditorID;
+	}
+
+	// Only objects outered to the template package are duplicated, meshes, materials and lighting data are shared
+	FObjectDuplicationParameters Parameters(Template, InstancePackage);
+	Parameters.DestName = Template->GetFName();
+	Parameters.DestClass = Template->GetClass();
+	Parameters.DuplicateMode = EDuplicateMode::World;
+	Parameters.PortFlags = PPF_None;
+
+	UWorld* World = CastChecked<UWorld>(StaticDuplicateObjectEx(Parameters));
+	World->ClearStreamingLevels();
+
+	return World;
+}
+
+bool UWorldDirector::IsLoadingRelatedWorld(FName WorldName) const
+{
+	return FindPendingLoad(WorldName) != nullptr;
+}
+
+float UWorldDirector::GetRelatedWorldLoadProgress(FName WorldName) const
+{
+	const FPendingWorldLoad* Load = FindPendingLoad(WorldName);
+
+	if (Load == nullptr)
+	{
+		return -1.f;
+	}
+
+	// Package loading takes the most of the time, init steps share the rest
+	const float PackageShare = 0.7f;
+
+	if (Load->Step == ERelatedWorldLoadStep::LS_PACKAGE)
+	{
+		const float PackagePercentage = Load->World != nullptr ? 100.f : FMath::Max(GetAsyncLoadPercentage(Load->PackageName), 0.f);
+		return PackagePercentage / 100.f * PackageShare;
+	}
+
+	const float NumSteps = (int32)ERelatedWorldLoadStep::LS_READY - (int32)ERelatedWorldLoadStep::LS_INIT_WORLD;
+	const float StepsDone = (int32)Load->Step - (int32)ERelatedWorldLoadStep::LS_INIT_WORLD;
+
+	return PackageShare + (1.f - PackageShare) * StepsDone / NumSteps;
+}
+
+bool UWorldDirector::CanLoadWorld(FName WorldName) const
+{
+	URelatedWorld* rWorld = Worlds.FindRef(WorldName);
+
+	if (rWorld != nullptr)
+	{
+		UE_LOG(LogWorldDirector, Warning, TEXT("World %s already loaded as %s"), *WorldName.ToString(), *rWorld->GetName());
+		return false;
+	}
+
+	if (IsLoadingRelatedWorld(WorldName))
+	{
+		UE_LOG(LogWorldDirector, Warning, TEXT("World %s is already loading"), *WorldName.ToString());
+		return false;
+	}
+
+	if (PendingUnloads.ContainsByPredicate([WorldName](const FPendingWorldUnload& Unload) { return Unload.WorldName == WorldName; }))
+	{
+		UE_LOG(LogWorldDirector, Warning, TEXT("World %s is still unloading"), *WorldName.ToString());
+		return false;
+	}
+
+	return true;
+}
+
+UWorld* UWorldDirector::LoadWorldPackage(const FString& MapName)
+{
+	UPackage* WorldPackage = nullptr;
+	UWorld* World = nullptr;
+	FName WorldName = FName(*MapName);
+
+	if (GPlayInEditorID > -1)
+	{
+		const FString PIEPackageName = UWorld::ConvertToPIEPackageName(MapName, GPlayInEditorID);
+		const FName PIEPackageFName = FName(*PIEPackageName);
+		UWorld::WorldTypePreLoadMap.FindOrAdd(PIEPackageFName) = EWorldType::Game;
+		FSoftObjectPath::AddPIEPackageName(PIEPackageFName);
+		UPackage* NewPackage = CreatePackage(nullptr, *PIEPackageName);
+		NewPackage->SetPackageFlags(PKG_PlayInEditor);
+		WorldPackage = LoadPackage(NewPackage, *MapName, LOAD_PackageForPIE);
+		UWorld::WorldTypePreLoadMap.Remove(PIEPackageFName);
+
+		if (WorldPackage == nullptr)
+		{
+			return nullptr;
+		}
+
+		World = UWorld::FindWorldInPackage(WorldPackage);
+		WorldPackage->PIEInstanceID = GPlayInEditorID;
+		WorldPackage->SetPackageFlags(PKG_PlayInEditor);
+
+		for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+		{
+			StreamingLevel->RenameForPIE(GPlayInEditorID);
+		}
+	}
+
+	if (World == nullptr)
+	{
+		UWorld::WorldTypePreLoadMap.FindOrAdd(WorldName) = EWorldType::Game;
+
+		WorldPackage = FindPackage(nullptr, *MapName);
+
+		if (WorldPackage == nullptr)
+		{
+			WorldPackage = LoadPackage(nullptr, *MapName, LOAD_None);
+		}
+
+		UWorld::WorldTypePreLoadMap.Remove(WorldName);
+
+		if (WorldPackage == nullptr)
+		{
+			return nullptr;
+		}
+
+		World = UWorld::FindWorldInPackage(WorldPackage);
+
+		if (World == nullptr)
+		{
+			return nullptr;
+		}
+
+		World->PersistentLevel->HandleLegacyMapBuildData();
+	}
+
+	return World;
+}
+
+FWorldContext& UWorldDirector::InitWorldContext(UObject* WorldContextObject, UWorld* World, int32 PIEInstance, bool IsNetWorld, const FRelatedWorldCreateParams& CreateParams)
+{
+	FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
+	Context.PIEInstance = PIEInstance;
+	Context.OwningGameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
+
+	World->SetGameInstance(Context.OwningGameInstance);
+	Context.SetCurrentWorld(World);
+	Context.World()->WorldType = Context.WorldType;
+
+	// The engine must not tick the world while it is initialized across frames
+	Context.World()->SetShouldTick(false);
+
+	if (PIEInstance > -1)
+	{
+		check(Context.World()->GetOutermost()->HasAnyPackageFlags(PKG_PlayInEditor));
+		Context.World()->ClearFlags(RF_Standalone);
+		Context.World()->RemoveFromRoot();
+	}
+	else
+	{
+		Context.World()->AddToRoot();
+	}
+
+	if (!Context.World()->bIsWorldInitialized)
+	{
+		Context.World()->InitWorld(MakeInitializationValues(CreateParams));
+	}
+
+	if (IsNetWorld)
+	{
+		UNetDriver* SharedNetDriver = WorldContextObject->GetWorld()->GetNetDriver();
+		Context.ActiveNetDrivers = GEngine->GetWorldContextFromWorld(WorldContextObject->GetWorld())->ActiveNetDrivers;
+		Context.World()->SetNetDriver(SharedNetDriver);
+		
+		FLevelCollection* LevelCollection = (FLevelCollection*)Context.World()->GetActiveLevelCollection();
+		LevelCollection->SetNetDriver(SharedNetDriver);
+	}
+	else
+	{
+		Context.ActiveNetDrivers.Empty();
+		Context.World()->NetDriver = nullptr;
+	}
+
+	return Context;
+}
+
+URelatedWorld* UWorldDirector::RegisterRelatedWorld(FWorldContext& Context, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld)
+{
+	URelatedWorld* rWorld = NewObject<URelatedWorld>(this);
+	rWorld->AddToRoot();
+	rWorld->SetWorldName(WorldName);
+	rWorld->SetContext(&Context);
+	rWorld->SetNetworked(IsNetWorld);
+	rWorld->SetDomain(WorldDomain);
+	rWorld->TranslateWorld(WorldTranslation);
+	rWorld->SetPersistentWorld(Context.OwningGameInstance->GetWorld());
+	rWorld->SetTickPolicy(DefaultTickPolicy);
+	rWorld->SetTickProfile(IsRunningDedicatedServer() ? ERelatedWorldTickProfile::TPR_SERVER : ERelatedWorldTickProfile::TPR_FULL);
+	rWorld->SetReferencedTickInterval(ReferencedTickInterval);
+	rWorld->SetCompactMovement(bCompactMovement);
+	rWorld->LocalBounds = ALevelBounds::CalculateLevelBounds(Context.World()->PersistentLevel);
+
+	// Info must exist before actors spawned on begin play pick up the world id
+	if (IsNetWorld)
+	{
+		CreateWorldInfo(rWorld);
+	}
+
+	// Restored state must be in place before actors begin play
+	if (RestoringSnapshot != nullptr)
+	{
+		ApplyWorldSnapshot(rWorld, *RestoringSnapshot);
+	}
+
+	rWorld->HandleBeginPlay();
+
+	Worlds.Add(WorldName, rWorld);
+	WorldRegistry.Add(Context.World(), rWorld);
+
+	AddToSpatialIndex(rWorld);
+
+	return rWorld;
+}
+
+void UWorldDirector::CreateWorldInfo(URelatedWorld* RelatedWorld)
+{
+	UWorld* PersistentWorld = RelatedWorld->GetWorld();
+
+	if (PersistentWorld == nullptr || PersistentWorld->GetNetMode() != NM_DedicatedServer)
+	{
+		return;
+	}
+
+	uint16 WorldId = 0;
+
+	for (int32 i = 0; i < MAX_uint16 && WorldId == 0; ++i)
+	{
+		LastWorldId = LastWorldId == MAX_uint16 ? 1 : LastWorldId + 1;
+
+		if (!UsedWorldIds.Contains(LastWorldId))
+		{
+			WorldId = LastWorldId;
+		}
+	}
+
+	if (WorldId == 0)
+	{
+		UE_LOG(LogWorldDirector, Warning, TEXT("No free world id for %s, its translation is not replicated"), *RelatedWorld->GetWorldName().ToString());
+		return;
+	}
+
+	// Id must be set before BeginPlay registers the info
+	ARelatedWorldInfo* WorldInfo = PersistentWorld->SpawnActorDeferred<ARelatedWorldInfo>(ARelatedWorldInfo::StaticClass(), FTransform::Identity);
+	WorldInfo->InitWorldInfo(RelatedWorld, WorldId, RelatedWorld->GetWorldSector(), RelatedWorld->GetLocalBounds());
+	WorldInfo->FinishSpawning(FTransform::Identity);
+
+	UsedWorldIds.Add(WorldId);
+	RelatedWorld->WorldId = WorldId;
+	RelatedWorld->WorldInfo = WorldInfo;
+}
+
+void UWorldDirector::DestroyWorldInfo(URelatedWorld* RelatedWorld)
+{
+	if (RelatedWorld->WorldId == 0)
+	{
+		return;
+	}
+
+	if (ARelatedWorldInfo* WorldInfo = RelatedWorld->WorldInfo.Get())
+	{
+		WorldInfo->Destroy();
+	}
+
+	UsedWorldIds.Remove(RelatedWorld->WorldId);
+	RelatedWorld->WorldId = 0;
+	RelatedWorld->WorldInfo = nullptr;
+}
+
+static bool IsLevelStreamingPending(UWorld* World)
+{
+	if (World->IsVisibilityRequestPending())
+	{
+		return true;
+	}
+
+	for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+	{
+		if (StreamingLevel->HasLoadRequestPending())
+		{
+			return true;
+		}
+
+		if (StreamingLevel->GetLoadedLevel() != nullptr && StreamingLevel->ShouldBeVisible() && !StreamingLevel->IsLevelVisible())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool UWorldDirector::AdvanceWorldLoad(FPendingWorldLoad& Load, bool bAsync)
+{
+	switch (Load.Step)
+	{
+	case ERelatedWorldLoadStep::LS_PACKAGE:
+	{
+		if (Load.World == nullptr)
+		{
+			return false;
+		}
+
+		break;
+	}
+	case ERelatedWorldLoadStep::LS_INIT_WORLD:
+	{
+		if (!Load.WorldContextObject.IsValid())
+		{
+			UE_LOG(LogWorldDirector, Warning, TEXT("World %s load is failed, world context object is destroyed"), *Load.WorldName.ToString());
+
+			Load.World->RemoveFromRoot();
+			Load.World = nullptr;
+			Load.bFailed = true;
+			return false;
+		}
+
+		Load.Context = &InitWorldContext(Load.WorldContextObject.Get(), Load.World, Load.PIEInstance, Load.bNetWorld, Load.CreateParams);
+		break;
+	}
+	case ERelatedWorldLoadStep::LS_LOAD_CONTENT:
+	{
+		if (GShaderCompilingManager)
+		{
+			GShaderCompilingManager->ProcessAsyncResults(false, true);
+		}
+
+		if (bAsync)
+		{
+			if (!Load.bContentRequested)
+			{
+				Load.bContentRequested = true;
+				Load.NumContentPackagesLoading = RequestMapContent(Load);
+			}
+
+			if (Load.NumContentPackagesLoading > 0)
+			{
+				return false;
+			}
+		}
+
+		// Packages are already in memory after async requests, this only keeps them referenced by the engine
+		GEngine->LoadPackagesFully(Load.World, FULLYLOAD_Map, Load.World->PersistentLevel->GetOutermost()->GetName());
+		break;
+	}
+	case ERelatedWorldLoadStep::LS_STREAM_LEVELS:
+	{
+		if (bAsync)
+		{
+			// Streaming levels are loaded by the async loader, only visibility is updated here
+			Load.World->UpdateLevelStreaming();
+
+			if (IsLevelStreamingPending(Load.World))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			Load.World->FlushLevelStreaming(EFlushLevelStreamingType::Visibility);
+		}
+
+		if (!GIsEditor && !IsRunningDedicatedServer())
+		{
+			// If requested, duplicate dynamic levels here after the source levels are created.
+			Load.World->DuplicateRequestedLevels(Load.WorldName);
+		}
+
+		break;
+	}
+	case ERelatedWorldLoadStep::LS_INIT_ACTORS:
+	{
+		FString MapName = Load.WorldName.ToString();
+		FURL URL(*MapName);
+
+		if (Load.CreateParams.bCreateAISystem)
+		{
+			Load.World->CreateAISystem();
+		}
+
+		Load.World->InitializeActorsForPlay(URL, true);
+
+		if (Load.SharedNavData != nullptr)
+		{
+			URelatedNavigationSystem::AddToWorld(*Load.World, Load.SharedNavData);
+		}
+		else if (Load.CreateParams.bCreateNavigation)
+		{
+			FNavigationSystem::AddNavigationSystemToWorld(*Load.World, FNavigationSystemRunMode::GameMode);
+		}
+
+		Load.Context->LastURL = URL;
+		Load.Context->LastURL.Map = MapName;
+
+		Load.World->bWorldWasLoadedThisTick = true;
+		Load.World->SetShouldTick(false);
+		break;
+	}
+	case ERelatedWorldLoadStep::LS_BEGIN_PLAY:
+	{
+		Load.RelatedWorld = RegisterRelatedWorld(*Load.Context, Load.WorldName, Load.WorldTranslation, Load.WorldDomain, Load.bNetWorld);
+		Load.RelatedWorld->SetMapName(Load.MapName);
+		Load.RelatedWorld->SetCreateProfile(Load.CreateProfile);
+		break;
+	}
+	default:
+		return false;
+	}
+
+	Load.Step = (ERelatedWorldLoadStep)((uint8)Load.Step + 1);
+
+	return true;
+}
+
+void UWorldDirector::ProcessPendingLoads()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_ProcessPendingLoads);
+	CSV_SCOPED_TIMING_STAT(RelatedWorld, ProcessPendingLoads);
+	RELATEDWORLD_TRACE_SCOPE(RelatedWorld_ProcessPendingLoads);
+
+	const double EndTime = FPlatformTime::Seconds() + AsyncLoadTimeSlice / 1000.f;
+	bool bAdvanced = false;
+	TArray<FPendingWorldLoad> FinishedLoads;
+	bProcessingLoads = true;
+
+	for (int32 i = 0; i < PendingLoads.Num();)
+	{
+		FPendingWorldLoad& Load = PendingLoads[i];
+
+		while (!Load.bFailed && Load.Step != ERelatedWorldLoadStep::LS_READY && (!bAdvanced || FPlatformTime::Seconds() < EndTime))
+		{
+			if (!AdvanceWorldLoad(Load, true))
+			{
+				break;
+			}
+
+			bAdvanced = true;
+		}
+
+		if (Load.bFailed || Load.Step == ERelatedWorldLoadStep::LS_READY)
+		{
+			FinishedLoads.Add(MoveTemp(Load));
+			PendingLoads.RemoveAt(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	bProcessingLoads = false;
+	PendingLoads.Append(MoveTemp(QueuedLoads));
+	QueuedLoads.Reset();
+
+	// Delegates are executed after the loop, they may start another load
+	for (FPendingWorldLoad& Load : FinishedLoads)
+	{
+		Load.OnLoaded.ExecuteIfBound(Load.WorldName, Load.RelatedWorld);
+	}
+}
+
+void UWorldDirector::OnWorldPackageLoaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result, FName WorldName)
+{
+	UWorld::WorldTypePreLoadMap.Remove(PackageName);
+
+	FPendingWorldLoad* Load = FindPendingLoad(WorldName);
+
+	if (Load == nullptr)
+	{
+		return;
+	}
+
+	UWorld* World = (Result == EAsyncLoadingResult::Succeeded && LoadedPackage != nullptr) ? UWorld::FindWorldInPackage(LoadedPackage) : nullptr;
+
+	if (World == nullptr)
+	{
+		UE_LOG(LogWorldDirector, Warning, TEXT("World %s load is failed, package %s has no world"), *WorldName.ToString(), *PackageName.ToString());
+		Load->bFailed = true;
+		return;
+	}
+
+	if (Load->PIEInstance > -1)
+	{
+		LoadedPackage->PIEInstanceID = Load->PIEInstance;
+		LoadedPackage->SetPackageFlags(PKG_PlayInEditor);
+
+		for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+		{
+			StreamingLevel->RenameForPIE(Load->PIEInstance);
+		}
+	}
+	else
+	{
+		World->PersistentLevel->HandleLegacyMapBuildData();
+	}
+
+	// Keep the world alive until its world context references it
+	World->AddToRoot();
+	Load->World = World;
+}
+
+void UWorldDirector::OnContentPackageLoaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result, FName WorldName)
+{
+	FPendingWorldLoad* Load = FindPendingLoad(WorldName);
+
+	if (Load == nullptr)
+	{
+		return;
+	}
+
+	if (Result != EAsyncLoadingResult::Succeeded)
+	{
+		// LoadPackagesFully reports the missing package when the step runs
+		UE_LOG(LogWorldDirector, Warning, TEXT("World %s content package %s is not loaded"), *WorldName.ToString(), *PackageName.ToString());
+	}
+
+	Load->NumContentPackagesLoading = FMath::Max(Load->NumContentPackagesLoading - 1, 0);
+}
+
+int32 UWorldDirector::RequestMapContent(const FPendingWorldLoad& Load)
+{
+	const FString Tag = Load.World->PersistentLevel->GetOutermost()->GetName();
+	int32 NumRequests = 0;
+
+	for (const FFullyLoadedPackagesInfo& PackagesInfo : GEngine->PackagesToFullyLoad)
+	{
+		if (PackagesInfo.FullyLoadType != FULLYLOAD_Map || PackagesInfo.Tag != Tag)
+		{
+			continue;
+		}
+
+		for (const FName& PackageName : PackagesInfo.PackagesToLoad)
+		{
+			LoadPackageAsync(PackageName.ToString(), FLoadPackageAsyncDelegate::CreateUObject(this, &UWorldDirector::OnContentPackageLoaded, Load.WorldName));
+			++NumRequests;
+		}
+	}
+
+	return NumRequests;
+}
+
+FPendingWorldLoad* UWorldDirector::FindPendingLoad(FName WorldName)
+{
+	auto IsLoadOf = [WorldName](const FPendingWorldLoad& Load) { return Load.WorldName == WorldName; };
+	FPendingWorldLoad* Load = PendingLoads.FindByPredicate(IsLoadOf);
+
+	return Load != nullptr ? Load : QueuedLoads.FindByPredicate(IsLoadOf);
+}
+
+const FPendingWorldLoad* UWorldDirector::FindPendingLoad(FName WorldName) const
+{
+	auto IsLoadOf = [WorldName](const FPendingWorldLoad& Load) { return Load.WorldName == WorldName; };
+	const FPendingWorldLoad* Load = PendingLoads.FindByPredicate(IsLoadOf);
+
+	return Load != nullptr ? Load : QueuedLoads.FindByPredicate(IsLoadOf);
+}
+
+void UWorldDirector::UnloadAllRelatedWorlds()
+{
+	TArray<FName> LevelNames;
+	Worlds.GetKeys(LevelNames);
+	
+	for (FName LevelName : LevelNames)
+	{
+		UnloadRelatedWorldByName(LevelName);
+	}
+
+	TArray<FPendingWorldUnload> Unloads = MoveTemp(PendingUnloads);
+
+	for (FPendingWorldUnload& Unload : Unloads)
+	{
+		DestroyWorld(Unload.Context);
+	}
+
+	EmptyWorldPool();
+}
+
+void UWorldDirector::UnloadRelatedWorldByName(FName WorldName)
+{
+	if (!Worlds.Num())
+	{
+		return;
+	}
+
+	URelatedWorld* rWorld = Worlds.FindRef(WorldName);
+	
+	if (rWorld != nullptr)
+	{
+		UnloadRelatedWorld(rWorld);
+	}
+}
+
+void UWorldDirector::UnloadRelatedWorld(URelatedWorld* RelatedWorld)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_UnloadRelatedWorld);
+	CSV_SCOPED_TIMING_STAT(RelatedWorld, UnloadRelatedWorld);
+	RELATEDWORLD_TRACE_SCOPE(RelatedWorld_UnloadRelatedWorld);
+
+	check(RelatedWorld);
+
+	FWorldContext* Context = RelatedWorld->Context();
+
+	RemoveFromSpatialIndex(RelatedWorld);
+	DestroyWorldInfo(RelatedWorld);
+	RelatedWorld->SetContext(nullptr);
+	RelatedWorld->RemoveFromRoot();
+	Worlds.Remove(RelatedWorld->GetWorldName());
+	WorldRegistry.Remove(Context->World());
+
+	if (!RelatedWorld->GetCreateProfile().IsNone() || !RecycleWorld(Context))
+	{
+		DestroyWorld(Context);
+	}
+}
+
+void UWorldDirector::UnloadRelatedWorldAsync(URelatedWorld* RelatedWorld)
+{
+	check(RelatedWorld);
+
+	FWorldContext* Context = RelatedWorld->Context();
+
+	RemoveFromSpatialIndex(RelatedWorld);
+	DestroyWorldInfo(RelatedWorld);
+	RelatedWorld->SetContext(nullptr);
+	RelatedWorld->RemoveFromRoot();
+	Worlds.Remove(RelatedWorld->GetWorldName());
+	WorldRegistry.Remove(Context->World());
+
+	// Pooled worlds are reset instead of torn down
+	if (RelatedWorld->GetCreateProfile().IsNone() && RecycleWorld(Context))
+	{
+		return;
 	}
 
-	if (!Context.World()->bIsWorldInitialized)
+	FPendingWorldUnload& Unload = PendingUnloads.AddDefaulted_GetRef();
+	Unload.WorldName = RelatedWorld->GetWorldName();
+	Unload.Context = Context;
+
+	for (FActorIterator ActorIt(Context->World()); ActorIt; ++ActorIt)
 	{
-		Context.World()->InitWorld();
+		Unload.Actors.Add(*ActorIt);
 	}
 
-	if (IsNetWorld)
+	if (Context->World()->GetNetDriver() == nullptr)
 	{
-		UNetDriver* SharedNetDriver = WorldContextObject->GetWorld()->GetNetDriver();
-		Context.ActiveNetDrivers = GEngine->GetWorldContextFromWorld(WorldContextObject->GetWorld())->ActiveNetDrivers;
-		Context.World()->SetNetDriver(SharedNetDriver);
-		
-		FLevelCollection* LevelCollection = (FLevelCollection*)Context.World()->GetActiveLevelCollection();
-		LevelCollection->SetNetDriver(SharedNetDriver);
+		Unload.Step = ERelatedWorldUnloadStep::US_END_PLAY;
 	}
-	else
+}
+
+void UWorldDirector::ProcessPendingUnloads()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_ProcessPendingUnloads);
+	CSV_SCOPED_TIMING_STAT(RelatedWorld, ProcessPendingUnloads);
+	RELATEDWORLD_TRACE_SCOPE(RelatedWorld_ProcessPendingUnloads);
+
+	const double EndTime = FPlatformTime::Seconds() + AsyncUnloadTimeSlice / 1000.f;
+	bool bFinished = false;
+
+	while (PendingUnloads.Num() > 0 && FPlatformTime::Seconds() < EndTime)
 	{
-		Context.ActiveNetDrivers.Empty();
-		Context.World()->NetDriver = nullptr;
+		// EndPlay may start another unload and grow the array, so the entry is advanced out of it
+		FPendingWorldUnload Unload = MoveTemp(PendingUnloads[0]);
+		PendingUnloads.RemoveAt(0);
+
+		if (!AdvanceWorldUnload(Unload, EndTime))
+		{
+			PendingUnloads.Insert(MoveTemp(Unload), 0);
+			break;
+		}
+
+		bFinished = true;
 	}
 
-	if (GShaderCompilingManager)
+	if (bFinished && bCollectGarbageAfterUnload)
 	{
-		GShaderCompilingManager->ProcessAsyncResults(false, true);
+		GEngine->ForceGarbageCollection(false);
 	}
+}
+
+bool UWorldDirector::AdvanceWorldUnload(FPendingWorldUnload& Unload, double EndTime)
+{
+	// Actors are processed in batches to check the time not too often
+	const int32 BatchSize = 16;
 
-	GEngine->LoadPackagesFully(Context.World(), FULLYLOAD_Map, Context.World()->PersistentLevel->GetOutermost()->GetName());
-	Context.World()->FlushLevelStreaming(EFlushLevelStreamingType::Visibility);
+	UWorld* World = Unload.Context->World();
 
-	if (!GIsEditor && !IsRunningDedicatedServer())
+	if (Unload.Step == ERelatedWorldUnloadStep::US_DETACH_NET)
 	{
-		// If requested, duplicate dynamic levels here after the source levels are created.
-		Context.World()->DuplicateRequestedLevels(FName(*URL.Map));
-	}
+		UNetDriver* NetDriver = World->GetNetDriver();
 
-	Context.World()->CreateAISystem();
-	Context.World()->InitializeActorsForPlay(URL, true);
-	FNavigationSystem::AddNavigationSystemToWorld(*Context.World(), FNavigationSystemRunMode::GameMode);
+		while (Unload.NextActor < Unload.Actors.Num() && FPlatformTime::Seconds() < EndTime)
+		{
+			const int32 BatchEnd = FMath::Min(Unload.NextActor + BatchSize, Unload.Actors.Num());
 
-	Context.LastURL = URL;
-	Context.LastURL.Map = MapName;
+			for (; Unload.NextActor < BatchEnd; ++Unload.NextActor)
+			{
+				AActor* Actor = Unload.Actors[Unload.NextActor].Get();
 
-	Context.World()->bWorldWasLoadedThisTick = true;
-	Context.World()->SetShouldTick(false);
+				if (Actor == nullptr)
+				{
+					continue;
+				}
 
-	rWorld = NewObject<URelatedWorld>(this);
-	rWorld->AddToRoot();
-	rWorld->SetContext(&Context);
-	rWorld->SetNetworked(IsNetWorld);
-	rWorld->SetDomain(WorldDomain);
-	rWorld->TranslateWorld(WorldTranslation);
-	rWorld->SetPersistentWorld(Context.OwningGameInstance->GetWorld());
-	rWorld->HandleBeginPlay();
+				if (NetDriver->ShouldClientDestroyActor(Actor))
+				{
+					NetDriver->NotifyActorDestroyed(Actor);
+				}
 
-	Worlds.Add(WorldName, rWorld);
+				NetDriver->RemoveNetworkActor(Actor);
+			}
+		}
 
-	return rWorld;
-}
+		if (Unload.NextActor < Unload.Actors.Num())
+		{
+			return false;
+		}
 
-void UWorldDirector::UnloadAllRelatedWorlds()
-{
-	TArray<FName> LevelNames;
-	Worlds.GetKeys(LevelNames);
-	
-	for (FName LevelName : LevelNames)
+		Unload.Context->ActiveNetDrivers.Empty();
+		World->NetDriver = nullptr;
+
+		FLevelCollection* LevelCollection = (FLevelCollection*)World->GetActiveLevelCollection();
+
+		if (LevelCollection != nullptr)
+		{
+			LevelCollection->SetNetDriver(nullptr);
+		}
+
+		Unload.NextActor = 0;
+		Unload.Step = ERelatedWorldUnloadStep::US_END_PLAY;
+	}
+
+	if (Unload.Step == ERelatedWorldUnloadStep::US_END_PLAY)
 	{
-		UnloadRelatedWorldByName(LevelName);
+		while (Unload.NextActor < Unload.Actors.Num() && FPlatformTime::Seconds() < EndTime)
+		{
+			const int32 BatchEnd = FMath::Min(Unload.NextActor + BatchSize, Unload.Actors.Num());
+
+			for (; Unload.NextActor < BatchEnd; ++Unload.NextActor)
+			{
+				if (AActor* Actor = Unload.Actors[Unload.NextActor].Get())
+				{
+					Actor->RouteEndPlay(EEndPlayReason::LevelTransition);
+				}
+			}
+		}
+
+		if (Unload.NextActor < Unload.Actors.Num())
+		{
+			return false;
+		}
+
+		Unload.Step = ERelatedWorldUnloadStep::US_CLEANUP;
+
+		// Cleanup is not divisible, it is left for the next frame if the slice is spent
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			return false;
+		}
 	}
+
+	FinishDestroyWorld(Unload.Context);
+
+	return true;
 }
 
-void UWorldDirector::UnloadRelatedWorldByName(FName WorldName)
+void UWorldDirector::FlushPendingUnload(FName WorldName)
 {
-	if (!Worlds.Num())
-	{
-		return;
-	}
+	const int32 Index = PendingUnloads.IndexOfByPredicate([WorldName](const FPendingWorldUnload& Unload) { return Unload.WorldName == WorldName; });
 
-	URelatedWorld* rWorld = Worlds.FindRef(WorldName);
-	
-	if (rWorld != nullptr)
+	if (Index != INDEX_NONE)
 	{
-		UnloadRelatedWorld(rWorld);
+		// EndPlay may start another unload, so the entry is taken out of the array first
+		FPendingWorldUnload Unload = MoveTemp(PendingUnloads[Index]);
+		PendingUnloads.RemoveAt(Index);
+		AdvanceWorldUnload(Unload, MAX_dbl);
 	}
 }
 
-void UWorldDirector::UnloadRelatedWorld(URelatedWorld* RelatedWorld)
+void UWorldDirector::DestroyWorld(FWorldContext* Context)
 {
-	check(RelatedWorld);
-
-	FWorldContext* Context = RelatedWorld->Context();
-
-	RelatedWorld->SetContext(nullptr);
-	RelatedWorld->RemoveFromRoot();
-	Worlds.Remove(FName(Context->World()->URL.Map));
-
 	for (FActorIterator ActorIt(Context->World()); ActorIt; ++ActorIt)
 	{
 		ActorIt->RouteEndPlay(EEndPlayReason::LevelTransition);
 	}
 
-	Context->World()->CleanupWorld();
-	GEngine->WorldDestroyed(Context->World());
+	FinishDestroyWorld(Context);
+}
+
+void UWorldDirector::FinishDestroyWorld(FWorldContext* Context)
+{
+	UWorld* World = Context->World();
+	EmptyWorldActors.Remove(World);
+
+	World->CleanupWorld();
+	GEngine->WorldDestroyed(World);
 
 	// mark everything else contained in the world to be deleted
-	for (auto LevelIt(Context->World()->GetLevelIterator()); LevelIt; ++LevelIt)
+	for (auto LevelIt(World->GetLevelIterator()); LevelIt; ++LevelIt)
 	{
 		const ULevel* Level = *LevelIt;
 		if (Level)
@@ -278,7 +1345,7 @@ void UWorldDirector::UnloadRelatedWorld(URelatedWorld* RelatedWorld)
 		}
 	}
 
-	for (ULevelStreaming* LevelStreaming : Context->World()->GetStreamingLevels())
+	for (ULevelStreaming* LevelStreaming : World->GetStreamingLevels())
 	{
 		// If an unloaded levelstreaming still has a loaded level we need to mark its objects to be deleted as well
 		if (LevelStreaming->GetLoadedLevel() && (!LevelStreaming->ShouldBeLoaded() || !LevelStreaming->ShouldBeVisible()))
@@ -287,9 +1354,9 @@ void UWorldDirector::UnloadRelatedWorld(URelatedWorld* RelatedWorld)
 		}
 	}
 
-	Context->World()->RemoveFromRoot();
+	World->RemoveFromRoot();
 	Context->SetCurrentWorld(nullptr);
-	GEngine->DestroyWorldContext(Context->World());
+	GEngine->DestroyWorldContext(World);
 }
 
 AActor* UWorldDirector::SpawnActor(URelatedWorld* TargetWorld, UClass* Class, const FTransform& SpawnTransform, ESpawnActorCollisionHandlingMethod CollisionHandlingOverride, AActor* Owner)
@@ -301,15 +1368,25 @@ AActor* UWorldDirector::SpawnActor(URelatedWorld* TargetWorld, UClass* Class, co
 
 URelatedWorld* UWorldDirector::GetRelatedWorldFromActor(AActor* InActor) const
 {
-
-	if (!Worlds.Num() || InActor == nullptr || !IsValid(InActor))
+	if (!WorldRegistry.Num() || !IsValid(InActor))
 	{
 		return nullptr;
 	}
 
-	UWorld* ActorWorld = InActor->GetWorld();
+	return WorldRegistry.FindRef(InActor->GetWorld());
+}
+
+TArray<URelatedWorld*> UWorldDirector::GetRelatedWorlds() const
+{
+	TArray<URelatedWorld*> Result;
+	Worlds.GenerateValueArray(Result);
+
+	return Result;
+}
 
-	return Worlds.FindRef(FName(ActorWorld->URL.Map));
+URelatedWorld* UWorldDirector::GetRelatedWorldFromLevel(const ULevel* InLevel) const
+{
+	return InLevel != nullptr ? WorldRegistry.FindRef(InLevel->OwningWorld) : nullptr;
 }
 
 URelatedWorld* UWorldDirector::GetRelatedWorldByName(FName WorldName) const
@@ -319,66 +1396,141 @@ URelatedWorld* UWorldDirector::GetRelatedWorldByName(FName WorldName) const
 
 bool UWorldDirector::MoveActorToWorld(URelatedWorld* World, AActor* InActor, bool bTranslateLocation)
 {
-	if (!IsValid(InActor) || InActor->IsPendingKill())
+	TArray<AActor*> Actors;
+	Actors.Add(InActor);
+
+	return MoveActorsToWorld(World, Actors, bTranslateLocation) > 0;
+}
+
+int32 UWorldDirector::MoveActorsToWorld(URelatedWorld* World, const TArray<AActor*>& InActors, bool bTranslateLocation)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_MoveActorToWorld);
+	CSV_SCOPED_TIMING_STAT(RelatedWorld, MoveActorToWorld);
+	RELATEDWORLD_TRACE_SCOPE(RelatedWorld_MoveActorToWorld);
+
+	// Actors are grouped by their current world, so source world is resolved once per group
+	TMap<URelatedWorld*, TArray<AActor*>> Groups;
+
+	for (AActor* InActor : InActors)
 	{
-		return false;
+		if (IsValid(InActor) && !InActor->IsPendingKill())
+		{
+			Groups.FindOrAdd(GetRelatedWorldFromActor(InActor)).Add(InActor);
+		}
+	}
+
+	int32 NumMoved = 0;
+	TArray<AActor*> MovedActors;
+
+	for (TPair<URelatedWorld*, TArray<AActor*>>& Group : Groups)
+	{
+		MovedActors.Reset();
+		MoveActorGroup(World, Group.Key, Group.Value, bTranslateLocation, MovedActors);
+
+		if (MovedActors.Num() == 0)
+		{
+			continue;
+		}
+
+		NumMoved += MovedActors.Num();
+
+		if (OnMoveActorToWorld.IsBound())
+		{
+			for (AActor* Actor : MovedActors)
+			{
+				OnMoveActorToWorld.Broadcast(Actor, Group.Key, World);
+			}
+		}
+
+		OnMoveActorsToWorld.Broadcast(MovedActors, Group.Key, World);
 	}
 
-	URelatedWorld* OldRWorld = GetRelatedWorldFromActor(InActor);
-	UWorld* MainWorld = OldRWorld ? OldRWorld->GetWorld() : InActor->GetWorld();
+	return NumMoved;
+}
+
+void UWorldDirector::MoveActorGroup(URelatedWorld* World, URelatedWorld* OldRWorld, const TArray<AActor*>& InActors, bool bTranslateLocation, TArray<AActor*>& OutMovedActors)
+{
+	UWorld* MainWorld = OldRWorld ? OldRWorld->GetWorld() : InActors[0]->GetWorld();
 	
 	bool bNet = ((World != nullptr && World->IsNetworkedWorld()) || MainWorld->NetDriver != nullptr);
 	bool bOldNet = ((OldRWorld != nullptr && OldRWorld->IsNetworkedWorld()) || MainWorld->NetDriver != nullptr);
 
 	if (!(bNet & bOldNet))
 	{
-		if (bOldNet)
+		// Driver has no batch API, but the graph routes the whole group into the new world without a lookup per actor
+		UNetDriver* NetDriver = MainWorld->NetDriver;
+		URwReplicationGraphBase* Graph = NetDriver != nullptr ? Cast<URwReplicationGraphBase>(NetDriver->GetReplicationDriver()) : nullptr;
+
+		if (Graph != nullptr && bNet)
+		{
+			Graph->BeginMoveBatch(World);
+		}
+
+		for (AActor* InActor : InActors)
 		{
-			if (MainWorld->NetDriver->ShouldClientDestroyActor(InActor))
+			if (bOldNet)
+			{
+				if (NetDriver->ShouldClientDestroyActor(InActor))
+				{
+					NetDriver->NotifyActorDestroyed(InActor);
+				}
+
+				NetDriver->RemoveNetworkActor(InActor);
+			}
+
+			if (bNet)
 			{
-				MainWorld->NetDriver->NotifyActorDestroyed(InActor);
+				NetDriver->AddNetworkActor(InActor);
 			}
-			
-			MainWorld->NetDriver->RemoveNetworkActor(InActor);
 		}
 
-		if (bNet)
+		if (Graph != nullptr)
 		{
-			MainWorld->NetDriver->AddNetworkActor(InActor);
+			Graph->EndMoveBatch();
 		}
 	}
 
-	//Translate coordinates into new one
-	USceneComponent* RootComponent = InActor->GetRootComponent();
+	const FRelatedWorldSector OldSector = OldRWorld != nullptr ? OldRWorld->GetWorldSector() : FRelatedWorldSector();
+	const FRelatedWorldSector NewSector = World != nullptr ? World->GetWorldSector() : FRelatedWorldSector();
+	FIntVector Origin = World != nullptr ? World->Context()->World()->OriginLocation : MainWorld->OriginLocation;
+	ULevel* NewOuter = World != nullptr ? World->Context()->World()->PersistentLevel : MainWorld->PersistentLevel;
+	const bool bNeedsLocationComponent = World != nullptr && World->IsNetworkedWorld() && World->Context()->World()->GetNetMode() == NM_DedicatedServer;
+	bool bHasPlayer = false;
 
-	if (RootComponent)
+	for (AActor* InActor : InActors)
 	{
-		FIntVector OldTranslation = OldRWorld != nullptr ? OldRWorld->GetWorldTranslation() : FIntVector::ZeroValue;
-		FIntVector NewTranslation = World != nullptr ? World->GetWorldTranslation() : FIntVector::ZeroValue;
-
-		FVector Location = FRepMovement::RebaseOntoZeroOrigin(RootComponent->GetComponentLocation(), RootComponent);
+		//Translate coordinates into new one
+		USceneComponent* RootComponent = InActor->GetRootComponent();
 
-		if (bTranslateLocation)
+		if (RootComponent)
 		{
-			Location = URelatedWorldUtils::CONVERT_RelToRel(OldTranslation, NewTranslation, Location);
+			FVector Location = FRepMovement::RebaseOntoZeroOrigin(RootComponent->GetComponentLocation(), RootComponent);
+
+			if (bTranslateLocation)
+			{
+				Location = URelatedWorldUtils::CONVERT_RelToRelSector(OldSector, NewSector, Location);
+			}
+
+			FVector NewLocation = FRepMovement::RebaseOntoLocalOrigin(Location, Origin);
+
+			RootComponent->SetWorldLocation(NewLocation);
 		}
 
-		FIntVector Origin = World != nullptr ? World->Context()->World()->OriginLocation : MainWorld->OriginLocation;
-		FVector NewLocation = FRepMovement::RebaseOntoLocalOrigin(Location, Origin);
+		if (!InActor->Rename(nullptr, NewOuter))
+		{
+			continue;
+		}
 
-		RootComponent->SetWorldLocation(NewLocation);
-	}
+		OutMovedActors.Add(InActor);
 
-	ULevel* NewOuter = World != nullptr ? World->Context()->World()->PersistentLevel : MainWorld->PersistentLevel;
-	bool bMoved = InActor->Rename(nullptr, NewOuter);
+		APawn* Pawn = Cast<APawn>(InActor);
+		bHasPlayer |= (Pawn != nullptr && Pawn->IsPlayerControlled()) || InActor->IsA<APlayerController>();
 
-	if (bMoved)
-	{
-		URelatedLocationComponent* LocationComponent = Cast<URelatedLocationComponent>(InActor->GetComponentByClass(URelatedLocationComponent::StaticClass()));
+		URelatedLocationComponent* LocationComponent = InActor->FindComponentByClass<URelatedLocationComponent>();
 
 		if (LocationComponent != nullptr)
 		{
-			if (InActor->GetNetMode() != NM_DedicatedServer || World == nullptr || !World->IsNetworkedWorld())
+			if (!bNeedsLocationComponent)
 			{
 				LocationComponent->DestroyComponent();
 			}
@@ -387,17 +1539,212 @@ bool UWorldDirector::MoveActorToWorld(URelatedWorld* World, AActor* InActor, boo
 				LocationComponent->NotifyWorldChanged(World);
 			}
 		}
-		else
+		else if (bNeedsLocationComponent)
+		{
+			LocationComponent = NewObject<URelatedLocationComponent>(InActor, TEXT("LocationComponent"), RF_Transient);
+			LocationComponent->RegisterComponent();
+		}
+	}
+
+	if (bHasPlayer && World != nullptr && World->IsHibernated())
+	{
+		World->Wake(HibernationMaxCatchUpTime, HibernationCatchUpSteps);
+	}
+}
+
+bool UWorldDirector::IsTickable() const
+{
+	return !HasAnyFlags(RF_ClassDefaultObject) && (Worlds.Num() > 0 || PendingLoads.Num() > 0 || PendingUnloads.Num() > 0 || NeedsWorldPoolWarmUp());
+}
+
+void UWorldDirector::Tick(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RelatedWorld_TickWorlds);
+	CSV_SCOPED_TIMING_STAT(RelatedWorld, TickWorlds);
+	RELATEDWORLD_TRACE_SCOPE(RelatedWorld_TickWorlds);
+
+	if (PendingLoads.Num())
+	{
+		ProcessPendingLoads();
+	}
+
+	if (PendingUnloads.Num())
+	{
+		ProcessPendingUnloads();
+	}
+
+	if (NeedsWorldPoolWarmUp())
+	{
+		UpdateWorldPool();
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	TickingWorlds.Reset();
+	Worlds.GenerateValueArray(TickingWorlds);
+
+	UpdateViewerCounts();
+	UpdateHibernation(DeltaSeconds);
+
+	if (WorldsMemoryBudget > 0.f)
+	{
+		UpdateMemoryBudget();
+	}
+
+	TickingWorlds.RemoveAllSwap([DeltaSeconds](URelatedWorld* rWorld)
+	{
+		// Paused worlds keep their time, it is folded into the delta of the next tick
+		if (rWorld->Context() != nullptr && rWorld->GetTickLOD() == ERelatedWorldTickLOD::TL_PAUSED)
+		{
+			rWorld->DeferTick(DeltaSeconds);
+		}
+
+		return !rWorld->IsTickable();
+	}, false);
+	ScheduleWorlds(DeltaSeconds);
+
+	TickWorlds(DeltaSeconds);
+
+	const float TickTime = (FPlatformTime::Seconds() - StartTime) * 1000.f;
+	WorldsTickTime = FMath::Lerp(WorldsTickTime, TickTime, 0.1f);
+}
+
+void UWorldDirector::UpdateViewerCounts()
+{
+	UWorld* MainWorld = nullptr;
+
+	for (URelatedWorld* rWorld : TickingWorlds)
+	{
+		rWorld->SetViewerCount(0);
+		MainWorld = rWorld->PersistentWorld;
+	}
+
+	if (MainWorld == nullptr)
+	{
+		return;
+	}
+
+	for (FConstPlayerControllerIterator It = MainWorld->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+
+		if (PC == nullptr)
+		{
+			continue;
+		}
+
+		URelatedWorld* rWorld = GetRelatedWorldFromActor(PC->GetViewTarget());
+
+		if (rWorld != nullptr)
+		{
+			rWorld->SetViewerCount(rWorld->GetViewerCount() + 1);
+		}
+	}
+}
+
+void UWorldDirector::UpdateHibernation(float DeltaSeconds)
+{
+	for (URelatedWorld* rWorld : TickingWorlds)
+	{
+		if (rWorld->HasPendingCatchUp())
+		{
+			rWorld->CatchUp();
+		}
+
+		if (rWorld->GetViewerCount() > 0 || rWorld->ReferenceCount > 0)
+		{
+			// Any view target in the world wakes it, not only players moved by MoveActorToWorld
+			if (rWorld->IsHibernated())
+			{
+				rWorld->Wake(HibernationMaxCatchUpTime, HibernationCatchUpSteps);
+			}
+
+			rWorld->EmptyTime = 0.f;
+			continue;
+		}
+
+		// Empty time is tracked for all worlds, memory budget evicts the longest empty ones
+		rWorld->EmptyTime += DeltaSeconds;
+
+		if (!bAutoHibernate || rWorld->IsHibernated() || rWorld->GetWorldDomain() == EWorldDomain::WD_PUBLIC)
+		{
+			continue;
+		}
+
+		if (rWorld->EmptyTime >= HibernateDelay)
+		{
+			rWorld->Hibernate();
+		}
+	}
+}
+
+void UWorldDirector::ScheduleWorlds(float DeltaSeconds)
+{
+	if (WorldsTickBudget <= 0.f)
+	{
+		return;
+	}
+
+	// Reduced rate worlds which only fold the delta this frame cost nothing, they are kept out of the budget
+	int32 NumSkipping = 0;
+
+	for (int32 i = 0; i < TickingWorlds.Num(); ++i)
+	{
+		if (TickingWorlds[i]->WillSkipTick(DeltaSeconds))
+		{
+			Swap(TickingWorlds[i], TickingWorlds[NumSkipping++]);
+		}
+	}
+
+	// The most overdue worlds go first, viewed and public worlds are preferred
+	MakeArrayView(TickingWorlds).Slice(NumSkipping, TickingWorlds.Num() - NumSkipping).Sort([DeltaSeconds](const URelatedWorld& A, const URelatedWorld& B)
+	{
+		auto Urgency = [DeltaSeconds](const URelatedWorld& rWorld)
 		{
-			if (InActor->GetNetMode() == NM_DedicatedServer && World != nullptr && World->IsNetworkedWorld())
+			float Priority = 1.f + rWorld.GetViewerCount();
+
+			if (rWorld.GetWorldDomain() == EWorldDomain::WD_PUBLIC)
 			{
-				LocationComponent = NewObject<URelatedLocationComponent>(InActor, TEXT("LocationComponent"), RF_Transient);
-				LocationComponent->RegisterComponent();
+				Priority += 1.f;
 			}
+
+			return (rWorld.GetTickLag() + DeltaSeconds) * Priority;
+		};
+
+		return Urgency(A) > Urgency(B);
+	});
+
+	// Cost is predicted from the previous ticks, at least one world is ticked each frame
+	float PlannedCost = 0.f;
+	int32 NumScheduled = NumSkipping;
+
+	for (; NumScheduled < TickingWorlds.Num(); ++NumScheduled)
+	{
+		const float Cost = TickingWorlds[NumScheduled]->GetTickCost();
+
+		if (NumScheduled > NumSkipping && PlannedCost + Cost > WorldsTickBudget)
+		{
+			break;
 		}
 
-		OnMoveActorToWorld.Broadcast(InActor, OldRWorld, World);
+		PlannedCost += Cost;
+	}
+
+	for (int32 i = NumScheduled; i < TickingWorlds.Num(); ++i)
+	{
+		TickingWorlds[i]->DeferTick(DeltaSeconds);
 	}
 
-	return bMoved;
+	TickingWorlds.SetNum(NumScheduled, false);
+}
+
+void UWorldDirector::TickWorlds(float DeltaSeconds)
+{
+	for (URelatedWorld* rWorld : TickingWorlds)
+	{
+		if (rWorld->IsTickable())
+		{
+			rWorld->Tick(DeltaSeconds);
+		}
+	}
 }
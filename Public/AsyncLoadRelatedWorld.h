@@ -0,0 +1,52 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "AsyncLoadRelatedWorld.generated.h"
+
+class URelatedWorld;
+enum class EWorldDomain : uint8;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FAsyncLoadRelatedWorldResult, URelatedWorld*, World);
+
+UCLASS()
+class RELATEDWORLD_API UAsyncLoadRelatedWorld : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Load related world from map in background, the world is registered when ready
+	 *
+	 * @param	WorldName				Name of the loading map
+	 * @param	WorldTranslation		World translation relative to the permanent world
+	 * @param	IsNetWorld				Should the world replicate actors to connected clients
+	 * @param	CreateProfile			Entry of WorldCreateProfiles, None creates all subsystems
+	 *
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector", Meta = (WorldContext = "WorldContextObject", BlueprintInternalUseOnly = "true", DisplayName = "LoadRelatedWorldAsync"))
+		static UAsyncLoadRelatedWorld* LoadRelatedWorldAsync(UObject* WorldContextObject, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld = true, FName CreateProfile = NAME_None);
+
+	virtual void Activate() override;
+
+	UPROPERTY(BlueprintAssignable)
+		FAsyncLoadRelatedWorldResult OnLoaded;
+
+	UPROPERTY(BlueprintAssignable)
+		FAsyncLoadRelatedWorldResult OnFailed;
+
+private:
+	void HandleWorldLoaded(FName LoadedWorldName, URelatedWorld* World);
+
+	UPROPERTY()
+		UObject* WorldContextObject;
+
+	FName WorldName;
+	FIntVector WorldTranslation;
+	EWorldDomain WorldDomain;
+	bool bNetWorld;
+	FName CreateProfile;
+
+};
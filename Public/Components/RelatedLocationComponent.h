@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "RelatedWorldRepMovement.h"
 #if ENGINE_MINOR_VERSION >= 26
 #include "GameFramework/CharacterMovementReplication.h"
 #endif
@@ -11,6 +12,7 @@
 
 class UWorldDirector;
 class URelatedWorld;
+class ARelatedWorldInfo;
 
 DECLARE_DYNAMIC_MULTICAST_SPARSE_DELEGATE_OneParam(FRelatedLocationComponentWorldChanged, URelatedLocationComponent, OnRelatedWorldChanged, URelatedWorld*, RelatedWorld);
 DECLARE_DYNAMIC_MULTICAST_SPARSE_DELEGATE_OneParam(FRelatedLocationComponentWorldTranslationChanged, URelatedLocationComponent, OnRelatedWorldTranslationChanged, const FIntVector&, WorldTranslation);
@@ -25,11 +27,17 @@ public:
 	virtual void NotifyWorldChanged(URelatedWorld* NewWorld);
 	virtual void NotifyWorldTranslationChanged(const FIntVector& NewWorldTranslation, bool DispatchEvent = true);
 
+	/**
+	 * Returns translation of the owner world. On the server it is pulled from the world when the
+	 * world translation version changes, so TranslateWorld does not touch every component
+	 */
+	const FIntVector& GetWorldTranslation();
+
 	UFUNCTION()
-		void RelatedWorldReceiveNewTranslation(const FIntVector& NewWorldTranslation);
+		void OnRep_WorldId();
 
 	UFUNCTION()
-		void OnRep_WorldTranslation();
+		void OnRep_CompactMovement();
 
 /** BEGIN HOOKS **/
 
@@ -50,7 +58,8 @@ public:
 
 public:
 	virtual void InitializeComponent() override;
-	virtual void UninitializeComponent();
+	virtual void UninitializeComponent() override;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
 
 /** END UActorComponent Interface **/
 
@@ -58,6 +67,7 @@ public:
 
 public:
 	virtual void GetLifetimeReplicatedProps(TArray< class FLifetimeProperty >& OutLifetimeProps) const override;
+	virtual void PostInitProperties() override;
 
 //** END UObject Interface **/
 
@@ -69,10 +79,52 @@ public:
 		FRelatedLocationComponentWorldTranslationChanged OnRelatedWorldTranslationChanged;
 
 private:
+	/** Pull translation of the world if it is changed since the last read */
+	void SyncWorldTranslation();
+
+	/** Follow translation of the replicated world info, waits for the info if it is not received yet */
+	void BindWorldInfo(ARelatedWorldInfo* Info);
+	void UnbindWorldInfo();
+	void HandleWorldInfoAdded(ARelatedWorldInfo* Info);
+	void HandleWorldTranslationChanged(ARelatedWorldInfo* Info);
+
+	/** Pack movement of the owner when its world uses compact movement and switch off FRepMovement of the owner */
+	bool UpdateCompactMovement();
+	/** Apply received compact movement once translation of its world is known */
+	void ApplyCompactMovement();
+	/** Run OnRep_ReplicatedMovement of the owner through the hook with the world origin zeroed */
+	void RebaseReplicatedMovement();
+
 	URelatedWorld* RelatedWorld;
+	/** Translation version of RelatedWorld WorldTranslation was read at */
+	uint32 WorldTranslationVersion;
+
+	/** Translation itself is replicated once per world by ARelatedWorldInfo */
+	UPROPERTY(ReplicatedUsing=OnRep_WorldId)
+		uint16 WorldId;
+
+	FIntVector WorldTranslation;
+
+	/**
+	 * Bounds of the world when the component was initialized. Sent once with the initial state and never
+	 * changed, so every connection unpacks CompactMovement against the bounds it was packed with
+	 */
+	UPROPERTY(Replicated)
+		FBox CompactBounds;
+
+	/** Replaces ReplicatedMovement of the owner while the world uses compact movement */
+	UPROPERTY(ReplicatedUsing=OnRep_CompactMovement)
+		FRelatedWorldRepMovement CompactMovement;
+
+	bool bCompactMovementPending;
+
+	/** Location of ReplicatedMovement received before WorldInfo, rebased again when the info binds */
+	FVector PendingMovementLocation;
+	bool bMovementRebasePending;
 
-	UPROPERTY(ReplicatedUsing=OnRep_WorldTranslation)
-		FIntVector WorldTranslation;
+	TWeakObjectPtr<ARelatedWorldInfo> WorldInfo;
+	FDelegateHandle WorldTranslationHandle;
+	FDelegateHandle WorldInfoAddedHandle;
 
 #if ENGINE_MINOR_VERSION >= 26
 	FNetBitReader MoveResponseBitReader;
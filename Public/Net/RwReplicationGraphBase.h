@@ -66,6 +66,33 @@ private:
 	TArray<FRouterRule> RouterRule;
 };
 
+/**
+ * Holds infos of related worlds. Info of a public world is relevant to viewers outside of isolated worlds,
+ * info of other worlds only to viewers inside them
+ */
+UCLASS()
+class RELATEDWORLD_API UReplicationGraphNode_WorldInfo : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	void AddWorldInfo(const FNewReplicatedActorInfo& ActorInfo, URelatedWorld* RelatedWorld);
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& Actor, bool bWarnIfNotFound = true) override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+private:
+	UReplicationGraphNode_ActorList* CreateListNode();
+
+	UPROPERTY()
+		UReplicationGraphNode_ActorList* PublicWorldInfoNode;
+	UPROPERTY()
+		TMap<URelatedWorld*, UReplicationGraphNode_ActorList*> WorldInfoNodes;
+
+	/** World of every added info, NULL for public worlds */
+	TMap<AActor*, URelatedWorld*> InfoWorlds;
+};
+
 UCLASS()
 class RELATEDWORLD_API UReplicationGraphNode_GlobalGridSpatialization2D : public UReplicationGraphNode_GridSpatialization2D
 {
@@ -95,20 +122,37 @@ public:
 	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
 
 	UFUNCTION()
-		virtual void OnMoveActorToWorld(AActor* InActor, URelatedWorld* OldWorld, URelatedWorld* NewWorld);
+		virtual void OnMoveActorsToWorld(const TArray<AActor*>& InActors, URelatedWorld* OldWorld, URelatedWorld* NewWorld);
+
+	/** Actors added to the graph until EndMoveBatch are routed into the domain of World without looking their world up */
+	void BeginMoveBatch(URelatedWorld* World);
+	void EndMoveBatch();
 
 protected:
 	virtual void InitGlobalActorClassSettings() override;
 	virtual void InitGlobalGraphNodes() override;
 	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* ConnectionManager) override;
 
+	/** Route actors which got connection or changed world since the last frame */
+	void ProcessPendingActors();
+
 private:
 	UPROPERTY()
 		UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+	UPROPERTY()
+		UReplicationGraphNode_WorldInfo* WorldInfoNode;
+	/** World infos are routed once their world is set, it happens after they are added to the graph */
+	UPROPERTY()
+		TArray<AActor*> PendingWorldInfos;
 	UPROPERTY()
 		TArray<AActor*> ActorsWithoutConnection;
 	UPROPERTY()
 		TArray<AActor*> WorldChangePendingActors;
+	/** Domain of the new world of every pending actor, resolved once per moved group */
+	TArray<uint8> WorldChangePendingDomains;
+
+	bool bInMoveBatch = false;
+	URelatedWorld* MoveBatchWorld = nullptr;
 
 	UPROPERTY()
 		TMap<UNetConnection*, UReplicationGraphNode_AlwaysRelevant_ForConnection*> ConnectionRelevantNode;
@@ -4,8 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "RelatedWorldSector.h"
 #include "RelatedWorld.generated.h"
 
+class URelatedWorld;
+class ARelatedWorldInfo;
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnWorldTranslationChanged, const FIntVector&, WorldTranslation);
 
 UCLASS()
@@ -44,6 +48,31 @@ public:
 
 	static FVector CONVERT_RelToRel(const FIntVector& From, const FIntVector& To, const FVector& Location);
 
+	/**
+	 * Batch versions of CONVERT_ functions, locations are converted four at a time with SIMD.
+	 * Out must have the same number of elements as In, In and Out may be the same array
+	 */
+	static void CONVERT_RelToWorldBatch(TArrayView<const FVector> In, const FIntVector& Translation, TArrayView<FVector> Out);
+	static void CONVERT_WorldToRelBatch(TArrayView<const FVector> In, const FIntVector& Translation, TArrayView<FVector> Out);
+	static void CONVERT_RelToRelBatch(TArrayView<const FVector> In, const FIntVector& From, const FIntVector& To, TArrayView<FVector> Out);
+	static void CONVERT_RelToWorldBatch(TArrayView<const FTransform> In, const FIntVector& Translation, TArrayView<FTransform> Out);
+	static void CONVERT_WorldToRelBatch(TArrayView<const FTransform> In, const FIntVector& Translation, TArrayView<FTransform> Out);
+
+	/** Location of the related world as position in the global sector frame */
+	static FRelatedWorldSector CONVERT_RelToSector(const FRelatedWorldSector& WorldSector, const FVector& Location);
+
+	/** Position in the global sector frame as location of the related world */
+	static FVector CONVERT_SectorToRel(const FRelatedWorldSector& WorldSector, const FRelatedWorldSector& Position);
+
+	/** CONVERT_RelToRel for worlds placed by sectors, exact for any distance between the worlds */
+	static FVector CONVERT_RelToRelSector(const FRelatedWorldSector& From, const FRelatedWorldSector& To, const FVector& Location);
+
+	/** Batch RelatedWorldLocationToWorldLocation, origin rebasing of both worlds is applied */
+	static void RelatedWorldLocationsToWorldLocations(URelatedWorld* RelatedWorld, TArrayView<const FVector> In, TArrayView<FVector> Out);
+
+	/** Batch WorldLocationToRelatedWorldLocation, origin rebasing of both worlds is applied */
+	static void WorldLocationsToRelatedWorldLocations(URelatedWorld* RelatedWorld, TArrayView<const FVector> In, TArrayView<FVector> Out);
+
 	/** Returns the RelatedLocation component from giving actor */
 	UFUNCTION(BlueprintPure, Category = "WorldDirector")
 		static URelatedLocationComponent* GetRelatedLocationComponent(AActor* InActor);
@@ -87,6 +116,37 @@ enum class EWorldDomain : uint8
 	WD_ISOLATED	UMETA(DisplayName = "Isolated")
 };
 
+UENUM(BlueprintType)
+enum class ERelatedWorldTickPolicy : uint8
+{
+	/** Always tick at the server frame rate */
+	TP_ALWAYS		UMETA(DisplayName = "Always"),
+	/** Tick rate depends on viewers and references of the world */
+	TP_VIEWERAWARE	UMETA(DisplayName = "Viewer Aware")
+};
+
+UENUM(BlueprintType)
+enum class ERelatedWorldTickProfile : uint8
+{
+	/** Tick everything the engine world tick does */
+	TPR_FULL		UMETA(DisplayName = "Full"),
+	/** Skip render, FX, scene capture and performance tracker work which is useless without viewport */
+	TPR_SERVER		UMETA(DisplayName = "Server")
+};
+
+UENUM(BlueprintType)
+enum class ERelatedWorldTickLOD : uint8
+{
+	/** Someone is looking at the world, tick every frame */
+	TL_FULL			UMETA(DisplayName = "Full"),
+	/** World is only referenced, tick with reduced rate */
+	TL_REDUCED		UMETA(DisplayName = "Reduced"),
+	/** World is empty, do not tick */
+	TL_PAUSED		UMETA(DisplayName = "Paused"),
+	/** World is hibernated, do not tick until woken up */
+	TL_HIBERNATED	UMETA(DisplayName = "Hibernated")
+};
+
 UCLASS(BlueprintType)
 class RELATEDWORLD_API URelatedWorld : public UObject, public FTickableGameObject
 {
@@ -98,6 +158,18 @@ public:
 
 	FORCEINLINE FWorldContext* Context() const { return _Context; }
 
+	/** Returns the name the world was created or loaded with */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		FORCEINLINE FName GetWorldName() const { return WorldName; }
+
+	/** Returns the map or template the world was created from, None for empty worlds */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		FORCEINLINE FName GetMapName() const { return MapName; }
+
+	/** Returns the profile of WorldCreateProfiles the world was created with */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		FORCEINLINE FName GetCreateProfile() const { return CreateProfile; }
+
 	/** Returns true if the world support networking */
 	UFUNCTION(BlueprintPure, Category = "WorldDirector")
 		FORCEINLINE bool IsNetworkedWorld() const { return bIsNetworkedWorld; }
@@ -110,6 +182,25 @@ public:
 	UFUNCTION(BlueprintPure, Category = "WorldDirector")
 		FORCEINLINE FIntVector GetWorldTranslation() const { return WorldTranslation; }
 
+	/** Returns the position of the world in the global sector frame */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		FORCEINLINE FRelatedWorldSector GetWorldSector() const { return WorldSector; }
+
+	/** Returns true if the world sector does not fit into FIntVector and WorldTranslation is clamped */
+	FORCEINLINE bool IsTranslationClamped() const { return bTranslationClamped; }
+
+	/**
+	 * Domain the replication graph routes actors of the world into. Public worlds translated beyond WORLD_MAX
+	 * are out of reach of the global grid, they get a grid of their own like private worlds
+	 */
+	EWorldDomain GetReplicationDomain() const;
+
+	/** Returns id actors of the world replicate instead of its translation, zero for worlds which are not networked */
+	FORCEINLINE uint16 GetWorldId() const { return WorldId; }
+
+	/** Incremented by every translation change, readers compare it to pull the translation only when needed */
+	FORCEINLINE uint32 GetTranslationVersion() const { return TranslationVersion; }
+
 	/**
 	 * Spawn Actors with given transform
 	 * @return	Actor that just spawned
@@ -145,11 +236,158 @@ public:
 	/** Translate world to specified position  */
 	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
 		void TranslateWorld(FIntVector NewTranslation);
+
+	/**
+	 * Translate world to the position in the global sector frame. Worlds further than FIntVector allows
+	 * keep clamped WorldTranslation, use sector conversions for them
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void TranslateWorldSector(const FRelatedWorldSector& NewSector);
+
+	/** Returns bounds of the world content in translated space, invalid box if the bounds are unknown */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		FBox GetWorldBounds() const;
+
+	/**
+	 * Set bounds of the world content relative to the world. Loaded worlds start with bounds of
+	 * their persistent level, empty worlds have no bounds and are not found by location until it is called
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void SetWorldBounds(const FBox& Bounds);
+
+	/** Returns bounds of the world content without translation */
+	FORCEINLINE const FBox& GetLocalBounds() const { return LocalBounds; }
+
+	/** Returns true if movement of actors is replicated packed against the world bounds */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		FORCEINLINE bool IsCompactMovement() const { return bCompactMovement; }
+
+	/**
+	 * Replicate movement of actors with related location component as location inside the world bounds,
+	 * which takes fewer bits than FRepMovement for small worlds. Used on dedicated server for networked worlds only
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void SetCompactMovement(bool bCompact) { bCompactMovement = bCompact; }
+
+	/** Returns how the tick rate of the world is chosen */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		FORCEINLINE ERelatedWorldTickPolicy GetTickPolicy() const { return TickPolicy; }
+
+	/** Set how the tick rate of the world is chosen */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void SetTickPolicy(ERelatedWorldTickPolicy NewTickPolicy) { TickPolicy = NewTickPolicy; }
+
+	/** Set interval in seconds between ticks while the world is only referenced */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void SetReferencedTickInterval(float Interval) { ReferencedTickInterval = FMath::Max(Interval, 0.f); }
+
+	/** Returns which parts of the engine world tick are executed */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		FORCEINLINE ERelatedWorldTickProfile GetTickProfile() const { return TickProfile; }
+
+	/** Set which parts of the engine world tick are executed */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void SetTickProfile(ERelatedWorldTickProfile NewTickProfile) { TickProfile = NewTickProfile; }
+
+	/** Returns current tick rate of the world */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		ERelatedWorldTickLOD GetTickLOD() const;
+
+	/** Returns number of player view targets inside the world */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		FORCEINLINE int32 GetViewerCount() const { return ViewerCount; }
+
+	/** Returns simulation time in seconds the world is behind the server, gameplay may use it to compensate */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		FORCEINLINE float GetTickLag() const { return PendingDeltaSeconds + FixedTimestepAccumulator; }
+
+	/**
+	 * Simulate the world with fixed timestep instead of the server frame delta
+	 *
+	 * @param	TickRate				Ticks per second, zero disables fixed timestep
+	 * @param	MaxSubsteps				Max number of ticks per frame, time above it is dropped
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void SetFixedTickRate(float TickRate, int32 MaxSubsteps = 4);
+
+	/** Returns fixed timestep of the world in seconds or zero if the world ticks with the server frame delta */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		FORCEINLINE float GetFixedTimestep() const { return FixedTimestep; }
+
+	/** Returns averaged cost of the world tick in milliseconds */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		FORCEINLINE float GetTickCost() const { return TickCost; }
+
+	/** Returns N of RelatedWorld Slot N the world is shown as in stat RelatedWorld, zero without stats */
+	FORCEINLINE int32 GetStatSlot() const { return StatSlot; }
+
+	/** Returns true if the world is hibernated */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		FORCEINLINE bool IsHibernated() const { return bHibernated; }
+
+	/**
+	 * Stop ticking the world and make its actors net dormant until Wake is called.
+	 * Only private and isolated worlds can be hibernated
+	 * @return	true if the world is hibernated
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		bool Hibernate();
+
+	/** 
+	 * Resume hibernated world, time passed in hibernation is simulated on the next tick
+	 *
+	 * @param	MaxCatchUpTime			Max time in seconds to fast forward
+	 * @param	CatchUpSteps			Number of steps the catch up time is split to
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void Wake(float MaxCatchUpTime = 1.f, int32 CatchUpSteps = 1);
+
+	/** Keep the world ticking with reduced rate while nobody is looking at it */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void AddTickReference() { ++ReferenceCount; }
+
+	/** Release reference added by AddTickReference */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void RemoveTickReference() { ReferenceCount = FMath::Max(ReferenceCount - 1, 0); }
+
 private:
-	void SetContext(FWorldContext* Context) { _Context = Context; }
+	void SetContext(FWorldContext* Context);
+	void SetWorldName(FName Name);
+	void SetMapName(FName Name) { MapName = Name; }
+	void SetCreateProfile(FName Profile) { CreateProfile = Profile; }
 	void SetNetworked(bool bNetworked) { bIsNetworkedWorld = bNetworked; }
 	void SetDomain(EWorldDomain WorldDomain) { Domain = WorldDomain; }
 	void SetPersistentWorld(UWorld* World) { PersistentWorld = World; }
+	void SetViewerCount(int32 Count) { ViewerCount = Count; }
+
+	/** Returns true if the world will only fold the delta this frame because of its reduced tick rate */
+	FORCEINLINE bool WillSkipTick(float DeltaSeconds) const { return GetTickLOD() == ERelatedWorldTickLOD::TL_REDUCED && PendingDeltaSeconds + DeltaSeconds < ReferencedTickInterval; }
+
+	/** Skip the tick this frame, time is added to the next delta */
+	void DeferTick(float DeltaSeconds) { PendingDeltaSeconds += DeltaSeconds; }
+	void UpdateTickCost(float Cost);
+
+	FORCEINLINE bool HasPendingCatchUp() const { return PendingCatchUpSteps > 0; }
+	/** Fast forward time passed in hibernation */
+	void CatchUp();
+
+	void HandleLevelsChanged(ULevel* Level, UWorld* World);
+
+	/**
+	 * Accumulate delta and compute number of steps to tick this frame. Folded delta longer than
+	 * MaxUndilatedFrameTime is split into several steps. Returns false if the world should not be ticked
+	 */
+	bool ConsumeTickDelta(float DeltaSeconds);
+	/** Run all tick stages with given delta, catch up passes bClampDelta false to skip FixupDeltaSeconds */
+	void TickStep(float DeltaSeconds, bool bClampDelta = true);
+	/** Game thread part of the tick before actors. Returns false if the world should not be ticked this frame */
+	bool BeginTick(float DeltaSeconds, bool bClampDelta = true);
+	/** Rebuild cached level tick lists if levels were added or removed */
+	void PrepareTick();
+	/** Run tick groups of the world */
+	void TickActors();
+	/** Game thread part of the tick after actors */
+	void EndTick();
 
 /** BEGIN FTickableGameObject Interface **/
 public:
@@ -157,7 +395,9 @@ public:
 	bool IsTickable() const override;
 	bool IsTickableInEditor() const override { return false; };
 	bool IsTickableWhenPaused() const override { return true; };
-	TStatId GetStatId() const override { return TStatId(); };
+	TStatId GetStatId() const override { return StatId; };
+	/** Related worlds are ticked by UWorldDirector */
+	ETickableTickType GetTickableTickType() const override { return ETickableTickType::Never; };
 
 /** END FTickableGameObject Interface **/
 
@@ -173,7 +413,63 @@ public:
 private:
 	FWorldContext* _Context;
 	UWorld* PersistentWorld;
+	FName WorldName;
+	FName MapName;
+	FName CreateProfile;
+	FString TraceName;
+	TStatId StatId;
+
+	/** One based index of the reused stat id, zero if the world holds none */
+	int32 StatSlot;
 	bool bIsNetworkedWorld;
+	bool bCompactMovement;
 	EWorldDomain Domain;
 	FIntVector WorldTranslation;
+	/** Precise translation, WorldTranslation is its 32-bit view */
+	FRelatedWorldSector WorldSector;
+	uint32 TranslationVersion;
+	bool bTranslationClamped;
+	uint16 WorldId;
+	/** Replicates translation of the world to clients, server only */
+	TWeakObjectPtr<ARelatedWorldInfo> WorldInfo;
+	/** Content bounds without translation */
+	FBox LocalBounds;
+
+	ERelatedWorldTickProfile TickProfile;
+	ERelatedWorldTickPolicy TickPolicy;
+	float ReferencedTickInterval;
+	int32 ViewerCount;
+	int32 ReferenceCount;
+	/** Time skipped by reduced tick rate, pause or frame budget, added to the next delta */
+	float PendingDeltaSeconds;
+	float TickCost;
+
+	float FixedTimestep;
+	float FixedTimestepAccumulator;
+	int32 MaxFixedSubsteps;
+	/** Steps computed by ConsumeTickDelta for the current frame */
+	int32 TickSteps;
+	float TickStepDeltaSeconds;
+	/** Time in seconds the world had no viewers, used for auto hibernation and eviction */
+	float EmptyTime;
+	/** Estimated memory in bytes, updated by UWorldDirector */
+	int64 MemoryUsage;
+
+	bool bHibernated;
+	double HibernationStartTime;
+	float PendingCatchUpTime;
+	int32 PendingCatchUpSteps;
+	TMap<TWeakObjectPtr<AActor>, TEnumAsByte<ENetDormancy>> HibernatedActorsDormancy;
+
+	/** Tick state shared between tick stages */
+	ELevelTick CurrentTickType;
+	float CurrentDeltaSeconds;
+	bool bCurrentTickPaused;
+	bool bDoingActorTicks;
+
+	/** Levels to tick for each level collection, rebuilt only when levels are added or removed */
+	TArray<TArray<ULevel*>> CollectionLevelsToTick;
+	bool bLevelsToTickDirty;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
 };
@@ -0,0 +1,83 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "RelatedWorldSector.h"
+#include "RelatedWorldInfo.generated.h"
+
+class ARelatedWorldInfo;
+class URelatedWorld;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnRelatedWorldInfoChanged, ARelatedWorldInfo*);
+
+/**
+ * Replicates translation and bounds of one networked related world. It lives in the persistent world,
+ * actors of the related world only replicate its WorldId. URwReplicationGraphBase sends it only to
+ * connections which can see the world, without the graph it is always relevant
+ */
+UCLASS(NotPlaceable, Transient)
+class RELATEDWORLD_API ARelatedWorldInfo : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ARelatedWorldInfo();
+
+	/** Returns info of the world with given id, NULL if it is not replicated yet */
+	static ARelatedWorldInfo* FindWorldInfo(const UWorld* World, uint16 WorldId);
+
+	/** Called on clients when info of any world is replicated */
+	static FOnRelatedWorldInfoChanged OnWorldInfoAdded;
+
+	/** Called when translation of this world is changed */
+	FOnRelatedWorldInfoChanged OnWorldTranslationChanged;
+
+	/** Called when bounds of this world are changed */
+	FOnRelatedWorldInfoChanged OnWorldBoundsChanged;
+
+	void InitWorldInfo(URelatedWorld* InRelatedWorld, uint16 InWorldId, const FRelatedWorldSector& InWorldSector, const FBox& InWorldBounds);
+	void SetWorldSector(const FRelatedWorldSector& InWorldSector);
+	void SetWorldBounds(const FBox& InWorldBounds);
+
+	FORCEINLINE uint16 GetWorldId() const { return WorldId; }
+	/** Returns the world this info replicates, server only */
+	FORCEINLINE URelatedWorld* GetRelatedWorld() const { return RelatedWorld.Get(); }
+	FORCEINLINE const FRelatedWorldSector& GetWorldSector() const { return WorldSector; }
+	FORCEINLINE const FIntVector& GetWorldTranslation() const { return WorldTranslation; }
+	/** Bounds of the world content without translation */
+	FORCEINLINE const FBox& GetWorldBounds() const { return WorldBounds; }
+
+	UFUNCTION()
+		void OnRep_WorldSector();
+
+	UFUNCTION()
+		void OnRep_WorldBounds();
+
+/** BEGIN AActor Interface **/
+
+public:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+/** END AActor Interface **/
+
+private:
+	UPROPERTY(Replicated)
+		uint16 WorldId;
+
+	UPROPERTY(ReplicatedUsing = OnRep_WorldSector)
+		FRelatedWorldSector WorldSector;
+
+	UPROPERTY(ReplicatedUsing = OnRep_WorldBounds)
+		FBox WorldBounds;
+
+	TWeakObjectPtr<URelatedWorld> RelatedWorld;
+
+	/** 32-bit view of WorldSector, clamped for worlds beyond its range */
+	FIntVector WorldTranslation;
+
+	static TMap<TTuple<const UWorld*, uint16>, ARelatedWorldInfo*> WorldInfos;
+};
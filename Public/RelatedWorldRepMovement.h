@@ -0,0 +1,76 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "RelatedWorldRepMovement.generated.h"
+
+/**
+ * Replicated movement of an actor in networked related world. Location inside the layout bounds is sent
+ * as offset from the bounds minimum with as many bits per axis as the bounds need at the location
+ * quantization of the actor, rotation and velocities are sent the same way FRepMovement sends them.
+ * Both sides derive the bit layout from the same bounds, so packed location has no size header
+ */
+USTRUCT()
+struct RELATEDWORLD_API FRelatedWorldRepMovement
+{
+	GENERATED_BODY()
+
+	FRelatedWorldRepMovement();
+
+	/** Take quantization levels of the actor movement, both sides must use the same */
+	void SetQuantization(const FRepMovement& Movement);
+
+	/**
+	 * Set bounds the location is packed against. They must be known to the receiver before the first
+	 * packed location and must not change while the movement is replicated
+	 */
+	FORCEINLINE void SetLayoutBounds(const FBox* InLayoutBounds) { LayoutBounds = InLayoutBounds; }
+
+	/** Copy movement to send, location is packed if it is inside the layout bounds */
+	void SetMovement(const FRepMovement& Movement);
+
+	/**
+	 * Write received movement into Movement
+	 * @return	false if location is packed and there are no layout bounds to unpack it
+	 */
+	bool GetMovement(FRepMovement& Movement) const;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FRelatedWorldRepMovement& Other) const;
+
+private:
+	/** Bounds minimum and bits per axis in quantized units, false if the bounds need more than 30 bits per axis */
+	bool GetLocationLayout(int64 OutMin[3], uint8 OutBits[3]) const;
+
+	FVector Location;
+	FRotator Rotation;
+	FVector LinearVelocity;
+	FVector AngularVelocity;
+
+	/** Location offsets of all axes written one after another, valid if bLocationPacked is set */
+	uint8 PackedLocation[12];
+
+	uint8 bSimulatedPhysicSleep : 1;
+	uint8 bRepPhysics : 1;
+	uint8 bLocationPacked : 1;
+
+	/** Owned by the replicating object, not replicated with the movement */
+	const FBox* LayoutBounds;
+
+	EVectorQuantization LocationQuantizationLevel;
+	EVectorQuantization VelocityQuantizationLevel;
+	ERotatorQuantization RotationQuantizationLevel;
+};
+
+template<>
+struct TStructOpsTypeTraits<FRelatedWorldRepMovement> : public TStructOpsTypeTraitsBase2<FRelatedWorldRepMovement>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
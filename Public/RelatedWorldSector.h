@@ -0,0 +1,76 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RelatedWorldSector.generated.h"
+
+class UPackageMap;
+
+/**
+ * Position in the global frame as 64-bit sector index and offset inside the sector.
+ * Unlike FIntVector translation it keeps full float precision of the offset at any distance
+ */
+USTRUCT(BlueprintType)
+struct RELATEDWORLD_API FRelatedWorldSector
+{
+	GENERATED_BODY()
+
+	/** Sector size in unreal units, 2^20 */
+	static constexpr int32 SectorShift = 20;
+	static constexpr float SectorSize = 1048576.f;
+
+	UPROPERTY()
+		int64 SectorX = 0;
+
+	UPROPERTY()
+		int64 SectorY = 0;
+
+	UPROPERTY()
+		int64 SectorZ = 0;
+
+	/** Offset inside the sector, in range [0, SectorSize) after Normalize */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WorldDirector")
+		FVector Offset = FVector::ZeroVector;
+
+	FRelatedWorldSector() {}
+	FRelatedWorldSector(int64 InSectorX, int64 InSectorY, int64 InSectorZ, const FVector& InOffset);
+
+	static FRelatedWorldSector FromTranslation(const FIntVector& Translation);
+
+	/** Returns false if the position does not fit into FIntVector */
+	bool ToTranslation(FIntVector& OutTranslation) const;
+
+	/** Position clamped to FIntVector range, each axis is clamped in 64-bit before it is narrowed */
+	FIntVector ToClampedTranslation() const;
+
+	/** Move whole sectors out of Offset */
+	void Normalize();
+
+	/** Position moved by local delta */
+	FRelatedWorldSector operator+(const FVector& Delta) const;
+
+	/** Delta between two positions, sectors are subtracted exactly before converting to float */
+	FVector operator-(const FRelatedWorldSector& Other) const;
+
+	bool operator==(const FRelatedWorldSector& Other) const
+	{
+		return SectorX == Other.SectorX && SectorY == Other.SectorY && SectorZ == Other.SectorZ && Offset == Other.Offset;
+	}
+
+	bool operator!=(const FRelatedWorldSector& Other) const { return !(*this == Other); }
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	FString ToString() const;
+};
+
+template<>
+struct TStructOpsTypeTraits<FRelatedWorldSector> : public TStructOpsTypeTraitsBase2<FRelatedWorldSector>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
@@ -0,0 +1,46 @@
+// Copyright Delta-Proxima Team (c) 2007-2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RelatedWorld.h"
+#include "RelatedWorldSnapshot.generated.h"
+
+/**
+ * Serialized state of a related world. Actors are stored with their class or map name,
+ * transform relative to the world translation and SaveGame properties
+ */
+USTRUCT(BlueprintType)
+struct RELATEDWORLD_API FRelatedWorldSnapshot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "WorldDirector")
+		FName WorldName;
+
+	/** Map or template the world was created from, None for empty worlds */
+	UPROPERTY(BlueprintReadOnly, Category = "WorldDirector")
+		FName MapName;
+
+	/** Profile of WorldCreateProfiles the world is restored with */
+	UPROPERTY(BlueprintReadOnly, Category = "WorldDirector")
+		FName CreateProfile;
+
+	UPROPERTY(BlueprintReadOnly, Category = "WorldDirector")
+		EWorldDomain WorldDomain = EWorldDomain::WD_PRIVATE;
+
+	UPROPERTY(BlueprintReadOnly, Category = "WorldDirector")
+		FIntVector WorldTranslation = FIntVector::ZeroValue;
+
+	/** Precise position of the world, differs from WorldTranslation for worlds placed beyond 32-bit range */
+	UPROPERTY(BlueprintReadOnly, Category = "WorldDirector")
+		FRelatedWorldSector WorldSector;
+
+	UPROPERTY(BlueprintReadOnly, Category = "WorldDirector")
+		bool bNetworked = false;
+
+	UPROPERTY()
+		TArray<uint8> Data;
+
+	bool IsValid() const { return !WorldName.IsNone(); }
+};
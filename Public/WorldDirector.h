@@ -4,20 +4,171 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "UObject/UObjectGlobals.h"
 #include "Modules/ModuleManager.h"
+#include "Tickable.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Trace/Trace.h"
+#include "Engine/EngineTypes.h"
 
 #include "RelatedWorldModuleInterface.h"
+#include "RelatedWorldSnapshot.h"
 #include "WorldDirector.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogWorldDirector, Log, All);
+DECLARE_STATS_GROUP(TEXT("RelatedWorld"), STATGROUP_RelatedWorld, STATCAT_Advanced);
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(RELATEDWORLD_API, RelatedWorld);
+
+#if ENGINE_MINOR_VERSION >= 26
+UE_TRACE_CHANNEL_EXTERN(RelatedWorldChannel, RELATEDWORLD_API);
+#define RELATEDWORLD_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Name, RelatedWorldChannel)
+#else
+#define RELATEDWORLD_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE(Name)
+#endif
 
 enum class EWorldDomain : uint8;
+enum class ERelatedWorldTickPolicy : uint8;
 class URelatedWorld;
+class UWorld;
+class UPackage;
+class UGameInstance;
+struct FWorldContext;
+class ANavigationData;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnMoveActorToWorld, AActor*, Actor, URelatedWorld*, OldWorld, URelatedWorld*, NewWorld);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnMoveActorsToWorld, const TArray<AActor*>&, Actors, URelatedWorld*, OldWorld, URelatedWorld*, NewWorld);
+/** Called when asynchronous load is finished, World is NULL if the load failed */
+DECLARE_DELEGATE_TwoParams(FOnRelatedWorldLoaded, FName /*WorldName*/, URelatedWorld* /*World*/);
+/** Called when the world is unloaded by memory budget, bSnapshot is true if its snapshot is kept */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnRelatedWorldEvicted, FName /*WorldName*/, bool /*bSnapshot*/);
+
+enum class ERelatedWorldLoadStep : uint8
+{
+	LS_PACKAGE,
+	LS_INIT_WORLD,
+	LS_LOAD_CONTENT,
+	LS_STREAM_LEVELS,
+	LS_INIT_ACTORS,
+	LS_BEGIN_PLAY,
+	LS_READY
+};
+
+enum class ERelatedWorldUnloadStep : uint8
+{
+	US_DETACH_NET,
+	US_END_PLAY,
+	US_CLEANUP
+};
 
-UCLASS(BlueprintType)
-class RELATEDWORLD_API UWorldDirector : public UObject
+/** Engine subsystems created for a related world, worlds which only hold data or capture scenes may skip most of them */
+USTRUCT(BlueprintType)
+struct RELATEDWORLD_API FRelatedWorldCreateParams
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WorldDirector")
+		bool bCreateAISystem = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WorldDirector")
+		bool bCreateNavigation = true;
+
+	/** Without physics scene components do not create bodies, so traces and overlaps find nothing */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WorldDirector")
+		bool bCreatePhysicsScene = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WorldDirector")
+		bool bCreateFXSystem = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WorldDirector")
+		bool bAllowAudioPlayback = true;
+};
+
+/** Line trace in translated space for UWorldDirector::LineTraceBatch */
+USTRUCT(BlueprintType)
+struct RELATEDWORLD_API FRelatedWorldLineTrace
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WorldDirector")
+		FVector Start = FVector::ZeroVector;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WorldDirector")
+		FVector End = FVector::ZeroVector;
+};
+
+/** Closest blocking hit of a batched trace, hit locations are in translated space */
+USTRUCT(BlueprintType)
+struct RELATEDWORLD_API FRelatedWorldTraceHit
+{
+	GENERATED_BODY()
+
+	/** World the hit was found in, NULL if nothing was hit */
+	UPROPERTY(BlueprintReadOnly, Category = "WorldDirector")
+		URelatedWorld* World = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category = "WorldDirector")
+		FHitResult Hit;
+};
+
+/** Overlap found by UWorldDirector::OverlapSphereBatch */
+USTRUCT(BlueprintType)
+struct RELATEDWORLD_API FRelatedWorldOverlap
+{
+	GENERATED_BODY()
+
+	/** Index of the query in the batch */
+	UPROPERTY(BlueprintReadOnly, Category = "WorldDirector")
+		int32 QueryIndex = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category = "WorldDirector")
+		URelatedWorld* World = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category = "WorldDirector")
+		AActor* Actor = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category = "WorldDirector")
+		UPrimitiveComponent* Component = nullptr;
+};
+
+/** Related world being torn down across frames */
+struct FPendingWorldUnload
+{
+	FName WorldName;
+	FWorldContext* Context = nullptr;
+	TArray<TWeakObjectPtr<AActor>> Actors;
+	int32 NextActor = 0;
+	ERelatedWorldUnloadStep Step = ERelatedWorldUnloadStep::US_DETACH_NET;
+};
+
+/** Related world being loaded, the world is initialized step by step across frames */
+struct FPendingWorldLoad
+{
+	FName WorldName;
+	FName MapName;
+	FName PackageName;
+	FIntVector WorldTranslation;
+	EWorldDomain WorldDomain;
+	bool bNetWorld;
+	int32 PIEInstance;
+	TWeakObjectPtr<UObject> WorldContextObject;
+	FOnRelatedWorldLoaded OnLoaded;
+
+	ERelatedWorldLoadStep Step = ERelatedWorldLoadStep::LS_PACKAGE;
+	bool bFailed = false;
+	/** Packages the engine fully loads for the map are requested once, then LS_LOAD_CONTENT waits for them */
+	bool bContentRequested = false;
+	int32 NumContentPackagesLoading = 0;
+	UWorld* World = nullptr;
+	FWorldContext* Context = nullptr;
+	URelatedWorld* RelatedWorld = nullptr;
+	ANavigationData* SharedNavData = nullptr;
+	FName CreateProfile;
+	FRelatedWorldCreateParams CreateParams;
+};
+
+UCLASS(BlueprintType, Config = Engine)
+class RELATEDWORLD_API UWorldDirector : public UObject, public FTickableGameObject
 {
 	GENERATED_BODY()
 
@@ -26,9 +177,16 @@ public:
 	UFUNCTION(BlueprintPure, Category = "WorldDirector", Meta=(DisplayName="GetWorldDirector"))
 		static UWorldDirector* Get()
 		{
-			return FModuleManager::LoadModuleChecked<IRelatedWorldModule>("RelatedWorld").GetWorldDirector();
+			if (Instance == nullptr)
+			{
+				Instance = FModuleManager::LoadModuleChecked<IRelatedWorldModule>("RelatedWorld").GetWorldDirector();
+			}
+
+			return Instance;
 		}
 
+	virtual void BeginDestroy() override;
+
 	/** 
 	 * Create empty related world without any actors
 	 * @return	RelatedWorld			new RelatedWorld object
@@ -36,10 +194,11 @@ public:
 	 * @param	WorldName				Name of the new world
 	 * @param	WorldTranslation		World translation relative to the permanent world
 	 * @param	IsNetWorld				Should the world replicate actors to connected clients
+	 * @param	CreateProfile			Entry of WorldCreateProfiles, None creates all subsystems
 	 * 
 	 */
 	UFUNCTION(BlueprintCallable, Category = "WorldDirector", Meta = (WorldContext = "WorldContextObject"))
-		URelatedWorld* CreateEmptyWorld(UObject* WorldContextObject, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld = true);
+		URelatedWorld* CreateEmptyWorld(UObject* WorldContextObject, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld = true, FName CreateProfile = NAME_None);
 
 	/**
 	 * Load related world from map
@@ -48,10 +207,85 @@ public:
 	 * @param	WorldName				Name of the loading map
 	 * @param	WorldTranslation		World translation relative to the permanent world
 	 * @param	IsNetWorld				Should the world replicate actors to connected clients
+	 * @param	CreateProfile			Entry of WorldCreateProfiles, None creates all subsystems
 	 * 
 	 */
 	UFUNCTION(BlueprintCallable, Category = "WorldDirector", Meta=(WorldContext="WorldContextObject"))
-		URelatedWorld* LoadRelatedWorld(UObject* WorldContextObject, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld = true);
+		URelatedWorld* LoadRelatedWorld(UObject* WorldContextObject, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld = true, FName CreateProfile = NAME_None);
+
+	/**
+	 * Load related world from map in background. The package is loaded asynchronously,
+	 * the world is initialized within AsyncLoadTimeSlice each frame and registered when ready
+	 * @return	true if the load is started
+	 *
+	 * @param	WorldName				Name of the loading map
+	 * @param	WorldTranslation		World translation relative to the permanent world
+	 * @param	IsNetWorld				Should the world replicate actors to connected clients
+	 * @param	OnLoaded				Called when the world is ready or the load is failed
+	 * @param	CreateProfile			Entry of WorldCreateProfiles, None creates all subsystems
+	 *
+	 */
+	bool LoadRelatedWorldAsync(UObject* WorldContextObject, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld, FOnRelatedWorldLoaded OnLoaded, FName CreateProfile = NAME_None);
+
+	/**
+	 * Load map once as a template for CreateWorldInstance. Template world is never initialized
+	 * and only its persistent level is instanced, streaming levels of the map are ignored
+	 * @return	true if the template is loaded
+	 *
+	 * @param	MapName					Name of the template map
+	 *
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		bool LoadWorldTemplate(FName MapName);
+
+	/** Release the template, already created instances are not affected */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void UnloadWorldTemplate(FName MapName);
+
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		bool IsWorldTemplateLoaded(FName MapName) const;
+
+	/**
+	 * Create related world by duplicating the template world in memory.
+	 * Assets referenced by the template are shared between instances
+	 * @return	RelatedWorld			new RelatedWorld object
+	 *
+	 * @param	TemplateName			Name of the template map, the template is loaded if needed
+	 * @param	WorldName				Unique name of the new world
+	 * @param	WorldTranslation		World translation relative to the permanent world
+	 * @param	IsNetWorld				Should the world replicate actors to connected clients
+	 * @param	CreateProfile			Entry of WorldCreateProfiles, None creates all subsystems
+	 *
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector", Meta = (WorldContext = "WorldContextObject"))
+		URelatedWorld* CreateWorldInstance(UObject* WorldContextObject, FName TemplateName, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld = true, FName CreateProfile = NAME_None);
+
+	/** Add or replace entry of WorldCreateProfiles, worlds already created with the profile are not affected */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void SetWorldCreateProfile(FName ProfileName, const FRelatedWorldCreateParams& CreateParams);
+
+	/** Returns true if the world is being loaded asynchronously */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		bool IsLoadingRelatedWorld(FName WorldName) const;
+
+	/** Returns progress of asynchronous load in range 0..1 or -1 if the world is not loading */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		float GetRelatedWorldLoadProgress(FName WorldName) const;
+
+	/**
+	 * Start filling the pool of empty worlds used by CreateEmptyWorld,
+	 * EmptyWorldPoolWarmUpRate worlds are created each frame until the pool has EmptyWorldPoolSize worlds
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector", Meta = (WorldContext = "WorldContextObject"))
+		void WarmUpWorldPool(UObject* WorldContextObject);
+
+	/** Destroy all empty worlds waiting in the pool */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void EmptyWorldPool();
+
+	/** Returns number of empty worlds ready in the pool */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		FORCEINLINE int32 GetWorldPoolSize() const { return WorldPool.Num(); }
 
 	/** Unload all loaded related worlds */
 	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
@@ -75,6 +309,64 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
 		void UnloadRelatedWorld(URelatedWorld* RelatedWorld);
 
+	/**
+	 * Unload related world over several frames within AsyncUnloadTimeSlice. The world stops ticking at once,
+	 * its actors are removed from the net driver, then EndPlay is called in batches and the world is cleaned up
+	 *
+	 * @param	RelatedWorld	The world to be unloaded
+	 *
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void UnloadRelatedWorldAsync(URelatedWorld* RelatedWorld);
+
+	/**
+	 * Serialize actors and settings of the world into compact binary snapshot.
+	 * Player controllers, player states and player controlled pawns are not stored
+	 * @return	true if the snapshot is made
+	 *
+	 * @param	RelatedWorld			The world to save
+	 * @param	OutSnapshot				Snapshot of the world
+	 *
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		bool SaveWorldSnapshot(URelatedWorld* RelatedWorld, FRelatedWorldSnapshot& OutSnapshot);
+
+	/**
+	 * Create the world from snapshot. The world is loaded from its map or template or created empty,
+	 * then actors of the map are updated and spawned actors are recreated
+	 * @return	RelatedWorld			restored RelatedWorld object
+	 *
+	 * @param	Snapshot				Snapshot made by SaveWorldSnapshot
+	 *
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector", Meta = (WorldContext = "WorldContextObject"))
+		URelatedWorld* RestoreWorldSnapshot(UObject* WorldContextObject, const FRelatedWorldSnapshot& Snapshot);
+
+	/**
+	 * Returns estimated memory in bytes used by objects of the world: actors, components, levels, navigation and AI data.
+	 * Assets shared with other worlds are not counted
+	 *
+	 * @param	RelatedWorld			The world to measure
+	 * @param	bForceUpdate			Measure the world now instead of returning the cached estimate
+	 *
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		int64 GetWorldMemoryUsage(URelatedWorld* RelatedWorld, bool bForceUpdate = false);
+
+	/** Returns sum of cached memory estimates of all related worlds in bytes */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		int64 GetWorldsMemoryUsage() const;
+
+	/** Returns true if snapshot of the world evicted by memory budget is kept */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		bool HasEvictedWorld(FName WorldName) const { return EvictedWorlds.Contains(WorldName); }
+
+	/** Restore the world evicted by memory budget from its snapshot */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector", Meta = (WorldContext = "WorldContextObject"))
+		URelatedWorld* RestoreEvictedWorld(UObject* WorldContextObject, FName WorldName);
+
+	FOnRelatedWorldEvicted OnRelatedWorldEvicted;
+
 	/**
 	 * Spawn Actors with given transform
 	 * @return	Actor that just spawned
@@ -109,6 +401,12 @@ public:
 	UFUNCTION(BlueprintPure, Category = "WorldDirector")
 		URelatedWorld* GetRelatedWorldFromActor(AActor* InActor) const;
 
+	/** Returns the related world which owns given UWorld or NULL */
+	FORCEINLINE URelatedWorld* GetRelatedWorldFromWorld(const UWorld* InWorld) const { return WorldRegistry.FindRef(InWorld); }
+
+	/** Returns the related world the level belongs to or NULL */
+	URelatedWorld* GetRelatedWorldFromLevel(const ULevel* InLevel) const;
+
 	/**
 	 * Returns the related world if world with giving name are loaded
 	 * @return	RelatedWorld		RelatedWorld object of NULL
@@ -119,6 +417,45 @@ public:
 	UFUNCTION(BlueprintPure, Category = "WorldDirector")
 		URelatedWorld* GetRelatedWorldByName(FName WorldName) const;
 
+	/** Returns all loaded related worlds */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		TArray<URelatedWorld*> GetRelatedWorlds() const;
+
+	/** Returns worlds whose bounds in translated space contain the location, worlds with clamped translation are not indexed */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		TArray<URelatedWorld*> FindWorldsAtLocation(const FVector& Location) const;
+
+	/** Returns worlds whose bounds in translated space intersect the box */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		TArray<URelatedWorld*> FindWorldsInBox(const FBox& Box) const;
+
+	/**
+	 * Trace every line against all related worlds whose bounds it crosses. Traces of each world
+	 * run as one batch, worlds are traced in parallel. Worlds without physics scene are skipped
+	 *
+	 * @param	Traces					Lines in translated space
+	 * @param	TraceChannel			Channel to trace
+	 * @param	OutHits					Closest blocking hit of every line over all worlds, in the order of Traces
+	 * @param	bTraceComplex			Trace against complex collision
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void LineTraceBatch(const TArray<FRelatedWorldLineTrace>& Traces, ETraceTypeQuery TraceChannel, TArray<FRelatedWorldTraceHit>& OutHits, bool bTraceComplex = false);
+
+	/**
+	 * Find components overlapping spheres in all related worlds whose bounds the spheres touch.
+	 * Worlds are queried in parallel, worlds without physics scene are skipped
+	 *
+	 * @param	Centers					Sphere centers in translated space
+	 * @param	Radius					Radius of every sphere
+	 * @param	TraceChannel			Channel to test
+	 * @param	OutOverlaps				Overlaps of all spheres, ordered by world
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		void OverlapSphereBatch(const TArray<FVector>& Centers, float Radius, ETraceTypeQuery TraceChannel, TArray<FRelatedWorldOverlap>& OutOverlaps);
+
+	/** Refresh the world in the spatial index after its bounds or translation are changed */
+	void UpdateSpatialIndex(URelatedWorld* RelatedWorld);
+
 	/**
 	 * Returns the related world if the actor is on it or NULL if not
 	 *
@@ -129,9 +466,239 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
 		bool MoveActorToWorld(URelatedWorld* World, AActor* InActor, bool bTranslateLocation);
 
+	/**
+	 * Move group of actors into the world. Source world, net driver state and target level are resolved
+	 * once per group of actors which share the same source world
+	 * @return	Number of moved actors
+	 *
+	 * @param	World					World to move. If NULL then actors will be moved into main world
+	 * @param	InActors				Actors for move
+	 * @param	bTranslateLocation		Translate current location into target space
+	 */
+	UFUNCTION(BlueprintCallable, Category = "WorldDirector")
+		int32 MoveActorsToWorld(URelatedWorld* World, const TArray<AActor*>& InActors, bool bTranslateLocation);
+
+	/** Broadcasted for every moved actor, prefer OnMoveActorsToWorld for batch processing */
 	FOnMoveActorToWorld OnMoveActorToWorld;
+	/** Broadcasted once per group of actors moved from the same world */
+	FOnMoveActorsToWorld OnMoveActorsToWorld;
+
+	/** Returns the average time in milliseconds spent on ticking all related worlds */
+	UFUNCTION(BlueprintPure, Category = "WorldDirector")
+		FORCEINLINE float GetWorldsTickTime() const { return WorldsTickTime; }
+
+public:
+	/** Tick policy assigned to new related worlds */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		ERelatedWorldTickPolicy DefaultTickPolicy;
+
+	/** Interval in seconds between ticks of new related worlds while they are only referenced */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		float ReferencedTickInterval = 0.25f;
+
+	/**
+	 * Time in milliseconds all related worlds may spend on tick each frame, zero means no limit.
+	 * Worlds which do not fit are ticked on the next frame with accumulated delta
+	 */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		float WorldsTickBudget;
+
+	/** Hibernate private and isolated worlds which have no viewers and references */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		bool bAutoHibernate;
+
+	/** Time in seconds the world should stay empty before auto hibernation */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		float HibernateDelay = 30.f;
+
+	/** Max time in seconds simulated when a player wakes hibernated world up */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		float HibernationMaxCatchUpTime = 1.f;
+
+	/** Number of coarse steps the catch up time is split to */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		int32 HibernationCatchUpSteps = 1;
+
+	/**
+	 * Time in milliseconds asynchronous loads may spend on world initialization each frame.
+	 * At least one step is done every frame, so a single heavy step may exceed the slice
+	 */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		float AsyncLoadTimeSlice = 5.f;
+
+	/**
+	 * Number of initialized empty worlds kept ready for CreateEmptyWorld, zero disables the pool.
+	 * Unloaded empty worlds are reset and returned to the pool while it has free slots
+	 */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		int32 EmptyWorldPoolSize;
+
+	/** Number of pooled worlds created each frame after WarmUpWorldPool, zero fills the pool only with released worlds */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		int32 EmptyWorldPoolWarmUpRate = 1;
+
+	/** Time in milliseconds asynchronous unloads may spend each frame */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		float AsyncUnloadTimeSlice = 2.f;
+
+	/**
+	 * Request garbage collection when asynchronous unload is finished. Unreachable objects are purged incrementally,
+	 * but reachability analysis still covers all objects, engine can not collect objects of one world only
+	 */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		bool bCollectGarbageAfterUnload;
+
+	/**
+	 * Memory in megabytes all related worlds may use, zero disables the budget. When it is exceeded
+	 * private and isolated worlds without viewers and references are unloaded, the longest empty first
+	 */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		float WorldsMemoryBudget;
+
+	/** Keep snapshot of worlds unloaded by memory budget, so they can be restored by RestoreEvictedWorld */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		bool bSnapshotEvictedWorlds = true;
+
+	/**
+	 * World instances use the first navigation data of their template instead of own copy. Only navigation data with
+	 * static runtime generation is shared, templates with dynamic navigation keep a copy per instance
+	 */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		bool bShareTemplateNavigation;
+
+	/** Named sets of subsystems for CreateEmptyWorld, LoadRelatedWorld and CreateWorldInstance */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "WorldDirector")
+		TMap<FName, FRelatedWorldCreateParams> WorldCreateProfiles;
+
+	/** Size of spatial index cells in unreal units, worlds are registered in every cell their bounds overlap */
+	UPROPERTY(Config, BlueprintReadOnly, Category = "WorldDirector")
+		float SpatialIndexCellSize = 100000.f;
+
+	/** Default of URelatedWorld::SetCompactMovement for new worlds */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "WorldDirector")
+		bool bCompactMovement;
+
+private:
+	/** Measure memory of the world from its packages */
+	int64 EstimateWorldMemory(URelatedWorld* RelatedWorld) const;
+	/** Update estimate of one world per frame and evict a world if the budget is exceeded */
+	void UpdateMemoryBudget();
+
+	void AddToSpatialIndex(URelatedWorld* RelatedWorld);
+	void RemoveFromSpatialIndex(URelatedWorld* RelatedWorld);
+	/** Returns false if the box covers too many cells to be registered cell by cell */
+	bool GetSpatialCellRange(const FBox& Box, FIntVector& OutMin, FIntVector& OutMax) const;
+	/** Spawn replicated info of the networked world on dedicated server */
+	void CreateWorldInfo(URelatedWorld* RelatedWorld);
+	void DestroyWorldInfo(URelatedWorld* RelatedWorld);
+
+	/** Group queries by worlds their bounds intersect, worlds without physics scene are dropped */
+	void GatherQueryWorlds(const TArray<FBox>& QueryBounds, TArray<URelatedWorld*>& OutWorlds, TArray<TArray<int32>>& OutQueries) const;
+
+	/** Apply actors of the snapshot to the just created world, called before the world begins play */
+	void ApplyWorldSnapshot(URelatedWorld* RelatedWorld, const FRelatedWorldSnapshot& Snapshot);
+	/** Returns true if the actor is a part of world state stored in snapshots */
+	bool ShouldSnapshotActor(URelatedWorld* RelatedWorld, AActor* Actor) const;
+
+	void MoveActorGroup(URelatedWorld* World, URelatedWorld* OldRWorld, const TArray<AActor*>& InActors, bool bTranslateLocation, TArray<AActor*>& OutMovedActors);
+
+	/** Returns parameters of the profile, unknown profile logs a warning and creates all subsystems */
+	FRelatedWorldCreateParams GetCreateParams(FName CreateProfile) const;
+
+	FWorldContext& CreateEmptyWorldContext(UGameInstance* GameInstance, FName WorldName, const FRelatedWorldCreateParams& CreateParams);
+	FWorldContext* AcquirePooledWorld(UGameInstance* GameInstance);
+	/** Initialize actors, AI and navigation of a pooled world again before it is registered */
+	void ReinitializePooledWorld(FWorldContext& Context);
+	/** Reset empty world and put it into the pool, returns false if the world can not be pooled */
+	bool RecycleWorld(FWorldContext* Context);
+	void DestroyWorld(FWorldContext* Context);
+	/** Cleanup world after EndPlay of its actors and destroy the world context */
+	void FinishDestroyWorld(FWorldContext* Context);
+	/** Advance asynchronous unloads within AsyncUnloadTimeSlice */
+	void ProcessPendingUnloads();
+	/** Run steps of the unload until EndTime, returns true when the world is destroyed */
+	bool AdvanceWorldUnload(FPendingWorldUnload& Unload, double EndTime);
+	/** Finish unloading of the world right away if it is pending */
+	void FlushPendingUnload(FName WorldName);
+	/** Create pooled worlds until the pool is full, limited by EmptyWorldPoolWarmUpRate */
+	void UpdateWorldPool();
+	bool NeedsWorldPoolWarmUp() const;
+
+	/** Returns false and logs if the world with given name is loaded or loading */
+	bool CanLoadWorld(FName WorldName) const;
+	/** Load map package and return its world, blocks until the package is loaded */
+	UWorld* LoadWorldPackage(const FString& MapName);
+	/** Duplicate persistent level of the template into a new package */
+	UWorld* DuplicateWorldTemplate(UWorld* Template, FName WorldName);
+	FWorldContext& InitWorldContext(UObject* WorldContextObject, UWorld* World, int32 PIEInstance, bool IsNetWorld, const FRelatedWorldCreateParams& CreateParams);
+	URelatedWorld* RegisterRelatedWorld(FWorldContext& Context, FName WorldName, FIntVector WorldTranslation, EWorldDomain WorldDomain, bool IsNetWorld);
+
+	/** Run the current step of the load, returns false if the step waits for streaming or failed */
+	bool AdvanceWorldLoad(FPendingWorldLoad& Load, bool bAsync);
+	/** Advance asynchronous loads within AsyncLoadTimeSlice and notify finished ones */
+	void ProcessPendingLoads();
+	void OnWorldPackageLoaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result, FName WorldName);
+	void OnContentPackageLoaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result, FName WorldName);
+	/** Request packages listed for the map in engine PackagesToFullyLoad, returns number of requests */
+	int32 RequestMapContent(const FPendingWorldLoad& Load);
+	FPendingWorldLoad* FindPendingLoad(FName WorldName);
+	const FPendingWorldLoad* FindPendingLoad(FName WorldName) const;
+
+	/** Fast forward woken up worlds and hibernate ones which stay empty */
+	void UpdateHibernation(float DeltaSeconds);
+	/** Order worlds by urgency and drop ones which do not fit into the frame budget */
+	void ScheduleWorlds(float DeltaSeconds);
+	/** Count player view targets in every related world */
+	void UpdateViewerCounts();
+	void TickWorlds(float DeltaSeconds);
+
+/** BEGIN FTickableGameObject Interface **/
+public:
+	void Tick(float DeltaSeconds) override;
+	bool IsTickable() const override;
+	bool IsTickableInEditor() const override { return false; };
+	bool IsTickableWhenPaused() const override { return true; };
+	TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UWorldDirector, STATGROUP_RelatedWorld); };
+
+/** END FTickableGameObject Interface **/
 
 private:
+	static UWorldDirector* Instance;
+
 	TMap<FName, URelatedWorld*> Worlds;
+	/** Direct lookup of related worlds by their UWorld, filled together with Worlds */
+	TMap<const UWorld*, URelatedWorld*> WorldRegistry;
+	TArray<FPendingWorldLoad> PendingLoads;
+	/** Loads started while PendingLoads is being processed, appended to it after the loop */
+	TArray<FPendingWorldLoad> QueuedLoads;
+	bool bProcessingLoads = false;
+	TArray<FPendingWorldUnload> PendingUnloads;
+	TMap<FName, UWorld*> WorldTemplates;
+
+	TArray<FWorldContext*> WorldPool;
+	/** Actors of every world created by CreateEmptyWorld right after its initialization */
+	TMap<const UWorld*, TArray<TWeakObjectPtr<AActor>>> EmptyWorldActors;
+	TWeakObjectPtr<UGameInstance> PoolGameInstance;
+
+	/** Uniform grid of world bounds in translated space */
+	TMap<FIntVector, TArray<URelatedWorld*, TInlineAllocator<2>>> SpatialCells;
+	/** Indexed bounds of every world, used to remove it from its cells */
+	TMap<const URelatedWorld*, FBox> SpatialBounds;
+	/** Worlds too large for the grid, checked one by one */
+	TArray<URelatedWorld*> LargeSpatialWorlds;
+
+	/** Ids of worlds with replicated info, zero is never used */
+	TSet<uint16> UsedWorldIds;
+	uint16 LastWorldId;
+
+	TMap<FName, FRelatedWorldSnapshot> EvictedWorlds;
+	/** Snapshot applied by RegisterRelatedWorld while RestoreWorldSnapshot creates the world */
+	const FRelatedWorldSnapshot* RestoringSnapshot = nullptr;
+	/** Round robin position of memory estimate updates */
+	int32 MemoryUpdateIndex;
+
+	/** Worlds collected for the current frame, Worlds may change while ticking */
+	TArray<URelatedWorld*> TickingWorlds;
+	float WorldsTickTime;
 
 };
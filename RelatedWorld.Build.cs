@@ -26,7 +26,8 @@ public class RelatedWorld : ModuleRules
 
 		PrivateDependencyModuleNames.AddRange(new string[]
 		{
-			"ReplicationGraph"
+			"ReplicationGraph",
+			"NavigationSystem"
 		});
 	}
 }